@@ -1,70 +1,69 @@
+// Retained drawing with dynamic parameters, see RenderOperation in src/vvg.hpp.
+// Frames are still built immediately with nanovg, operations are an addition to that.
 // TODO: add possibility to defer updates
 
+// Parameters are not observed. Every set increases a version and the renderer compares
+// the versions it wrote into the uniform slot of the current frame when the operation is
+// drawn, so changing a parameter multiple times per frame costs nothing extra.
 template<typename T>
-class Parameter {
+class DynamicParameter {
 public:
-	Parameter() = defualt;
-	Parameter(const T& value) : value_(value) {}
-	Parameter(T&& value) : value_(std::move(value)) {}
-	virtual ~Parameter() = default;
+	DynamicParameter() = default;
+	DynamicParameter(const T& value) : value_(value) {}
 
-	virtual bool dynamic() const noexcept { return false; }
-	virtual const T& get() const noexcept { return value_; }
+	void set(const T& value) { value_ = value; ++version_; }
+	const T& get() const { return value_; }
+	unsigned int version() const { return version_; }
 
 protected:
-	T value_;
+	T value_ {};
+	unsigned int version_ {};
 };
 
-template<typename T>
-class DynamicParameter : public Parameter<T> {
+class RenderOperation {
 public:
-	using Parameter::Parameter;
-
-	void set(const T& value) { value_ = value; updated(); }
-	void set(T&& value) { value_ = value; updated(); }
-	void updated() { if(observer_) observer_->changed(*this, value_); }
-
-	ParameterObserver<T>* observer() const { return observer_; }
-	void observer(ParameterObserver<T>* obs) const { return observer_ = obs; }
-
-	virtual bool dynamic() const noexcept { return true; }
-
-protected:
-	ParameterObserver<T>* observer_ {};
-};
-
-template<typename T>
-class ParameterObserver {
-	virtual void change(DynamicParameter<T>& obj, const T& value);
+	DynamicParameter<Vec2f> position; // applied in the vertex shader
+	DynamicParameter<Vec2f> scale; // applied in the vertex shader
+	DynamicParameter<Vec4f> color; // multiplies the paint colors
 };
 
 class Renderer {
 public:
-	void rect(const Parameter<Vec2ui>& pos, const Parameter<Vec2ui>& size);
+	void beginOperation(RenderOperation&); // nanovg calls are captured into the operation
+	void endOperation(); // geometry is written into buffers owned by the operation
+	void draw(RenderOperation&); // adds the operation to the current frame
 };
 
 
 
 
-// static drawing
-renderer.rect({0, 0}, {100, 100});
-renderer.fill();
-renderer.record();
-
+// immediate drawing, tessellated and uploaded every frame
 every frame {
-	renderer.draw();
+	nvgBeginFrame(ctx, width, height, 1.f);
+	nvgRect(ctx, 0, 0, 100, 100);
+	nvgFill(ctx);
+	nvgEndFrame(ctx);
 }
 
 
-// dynamic drawing
-DyanmicParameter<Vec2ui> position;
-DyanmicParameter<Vec2ui> size;
+// static drawing, captured once
+RenderOperation operation;
+renderer.beginOperation(operation);
+nvgRect(ctx, 0, 0, 100, 100);
+nvgFill(ctx);
+renderer.endOperation();
+
+every frame {
+	nvgBeginFrame(ctx, width, height, 1.f);
+	renderer.draw(operation);
+	nvgEndFrame(ctx);
+}
 
-renderer.rect(position, size);
-renderer.fill();
-renderer.record();
 
+// dynamic drawing, only the uniform data of the operation is rewritten
 every frame {
-	updateRectAnimation(position, size);
-	renderer.draw();
+	nvgBeginFrame(ctx, width, height, 1.f);
+	operation.position.set(updateRectAnimation());
+	renderer.draw(operation);
+	nvgEndFrame(ctx);
 }
@@ -1,46 +1,57 @@
 /// The data specifying how something should be drawn.
-/// Basically the render state, in nanovg terms.
-class RenderData {
+/// Basically the render state, in nanovg terms. Implemented as DrawData, the same
+/// struct the immediate frames use.
+class DrawData {
 public:
-	- transform
-	- scissor
-	- color (or gradient or texture)
-};
-
-
-class RenderPath {
-public:
-	- points and stuff
+	- uniform data: transform, scissor, color (or gradient or texture)
+	- texture and pipeline variant
+	- ranges of the paths in the vertex (and index) data
+	- stroke/fill/triangles
 };
 
+/// Retained group of nanovg draw calls, see src/vvg.hpp.
 class RenderOperation {
 public:
-	- RenderData
-	- RenderPath
-	- stroke/fill/text
+	- dynamic parameters: position, scale, color
+	- DrawDatas captured between Renderer::beginOperation and endOperation
+	- own vertex and index buffers, written once by endOperation
+	- uniform buffer with one slot per frame in flight and draw
+	- the renderer that captured it
 };
 
 
 // Degress of freedom:
 // - which buffer memory type to use (often updated?)
+//  - host visible for now, the geometry is written once
 // - which things should be changeable at runtime
+//  - position, scale and color for now, they only change uniform data
 //  - e.g. if it is alwasys a rectangle use vkCmdDraw, otherwise vkCmdDrawIndirect
 
 
+// Operations are drawn inside a frame, the renderer records their draws
+// with their own buffers between the draws of the frame.
 class MyRenderer {
 public:
 	void init() {
-		op_ = RenderOperatoin::rect({0, 0}, {10, 10}, Color::red);
+		renderer.beginOperation(op_);
+		nvgBeginPath(ctx);
+		nvgRect(ctx, 0, 0, 10, 10);
+		nvgFillColor(ctx, nvgRGB(255, 0, 0));
+		nvgFill(ctx);
+		renderer.endOperation();
 	}
 
 	void update() {
 		if(condition) {
-			// some examples
+			op_.position.set({x, y});
+			op_.color.set({1.f, 1.f, 1.f, 0.5f});
 		}
 	}
 
-	void record(vk::CommandBuffer cmdBuf) {
-		op_.record(cmdBuf);
+	void frame() {
+		nvgBeginFrame(ctx, width, height, 1.f);
+		renderer.draw(op_);
+		nvgEndFrame(ctx);
 	}
 
 	RenderOperation op_;
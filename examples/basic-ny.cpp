@@ -12,6 +12,8 @@
 class MyWindowListener : public ny::WindowListener {
 public:
 	bool* run;
+	nytl::Vec2ui* size;
+	bool* resized;
 
 	void close(const ny::CloseEvent& ev) override {
 		*run = false;
@@ -20,12 +22,16 @@ public:
 		if(ev.pressed && ev.keycode == ny::Keycode::escape)
 			*run = false;
 	}
+	void resize(const ny::SizeEvent& ev) override {
+		*size = ev.size;
+		*resized = true;
+	}
 };
 
 int main()
 {
-	constexpr auto width = 1200u;
-	constexpr auto height = 800u;
+	auto width = 1200u;
+	auto height = 800u;
 
 	// init ny app
 	auto& backend = ny::Backend::choose();
@@ -59,9 +65,13 @@ int main()
 
 	// ny init
 	auto run = true;
+	auto resized = false;
+	auto size = nytl::Vec2ui {width, height};
 
 	auto listener = MyWindowListener {};
 	listener.run = &run;
+	listener.size = &size;
+	listener.resized = &resized;
 
 	auto vkSurface = vk::SurfaceKHR {};
 	auto ws = ny::WindowSettings {};
@@ -91,6 +101,18 @@ int main()
 		if(!ac->dispatchEvents())
 			break;
 
+		// only the swapchain dependent objects of the renderer are recreated
+		if(resized) {
+			resized = false;
+			width = size[0];
+			height = size[1];
+
+			auto& renderer = vvg::getRenderer(*nvgContext);
+			renderer.wait();
+			swapchain.resize({width, height});
+			renderer.resize();
+		}
+
 		nvgBeginFrame(nvgContext, width, height, width / (float) height);
 
 		nvgBeginPath(nvgContext);
@@ -0,0 +1,398 @@
+// Checks the behavior of the renderer on the first device by rendering small scenes
+// offscreen and comparing their pixels and frame statistics.
+// Prints every failed check and returns 1 if there was any.
+
+#include <vvg.hpp>
+
+#include <vpp/device.hpp>
+#include <vpp/instance.hpp>
+#include <vpp/vk.hpp>
+
+#include <nanovg.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace {
+
+using Scene = std::function<void(NVGcontext*)>;
+using Pixels = std::vector<std::uint8_t>;
+
+constexpr auto size = 64u;
+unsigned int failed = 0;
+
+void check(bool condition, const char* what)
+{
+	if(!condition) {
+		std::printf("FAILED: %s\n", what);
+		++failed;
+	}
+}
+
+NVGcontext* create(const vpp::Device& dev, const vvg::RendererSettings& settings = {})
+{
+	auto renderer = std::make_unique<vvg::OffscreenRenderer>(dev, vk::Extent2D {size, size},
+		vk::Format::r8g8b8a8Unorm, settings);
+	return vvg::createContext(std::move(renderer));
+}
+
+vvg::OffscreenRenderer& offscreen(NVGcontext* ctx)
+{
+	return static_cast<vvg::OffscreenRenderer&>(vvg::getRenderer(*ctx));
+}
+
+// Flushes a frame with the given scene without waiting for its pixels.
+void frame(NVGcontext* ctx, const Scene& scene)
+{
+	nvgBeginFrame(ctx, size, size, 1.f);
+	scene(ctx);
+	nvgEndFrame(ctx);
+}
+
+// Renders a frame with the given scene and returns its pixels.
+Pixels render(NVGcontext* ctx, const Scene& scene)
+{
+	auto future = offscreen(ctx).nextFrame();
+	frame(ctx, scene);
+	offscreen(ctx).wait();
+	return future.get().data;
+}
+
+const std::uint8_t* pixel(const Pixels& pixels, unsigned int x, unsigned int y)
+{
+	return pixels.data() + 4 * (y * size + x);
+}
+
+// Whether both images differ by at most the given value in every channel.
+bool similar(const Pixels& a, const Pixels& b, int tolerance = 1)
+{
+	if(a.size() != b.size())
+		return false;
+
+	for(auto i = 0u; i < a.size(); ++i)
+		if(std::abs(int(a[i]) - int(b[i])) > tolerance)
+			return false;
+
+	return true;
+}
+
+void rect(NVGcontext* ctx, float x, float y, float w, float h, NVGcolor color)
+{
+	nvgBeginPath(ctx);
+	nvgRect(ctx, x, y, w, h);
+	nvgFillColor(ctx, color);
+	nvgFill(ctx);
+}
+
+// Uses convex fills (fans), concave and multi-contour fills (stencil then cover),
+// strokes (strips) and a gradient.
+void shapes(NVGcontext* ctx)
+{
+	rect(ctx, 4, 4, 24, 24, nvgRGB(255, 0, 0));
+
+	nvgBeginPath(ctx);
+	nvgMoveTo(ctx, 36, 4);
+	nvgLineTo(ctx, 60, 4);
+	nvgLineTo(ctx, 48, 16);
+	nvgLineTo(ctx, 60, 28);
+	nvgLineTo(ctx, 36, 28);
+	nvgClosePath(ctx);
+	nvgCircle(ctx, 8, 48, 6);
+	nvgFillColor(ctx, nvgRGB(0, 255, 0));
+	nvgFill(ctx);
+
+	nvgBeginPath(ctx);
+	nvgMoveTo(ctx, 20, 60);
+	nvgBezierTo(ctx, 30, 30, 50, 60, 60, 36);
+	nvgStrokeWidth(ctx, 3);
+	nvgStrokeColor(ctx, nvgRGB(0, 0, 255));
+	nvgStroke(ctx);
+
+	nvgBeginPath(ctx);
+	nvgRoundedRect(ctx, 24, 36, 16, 12, 4);
+	nvgFillPaint(ctx, nvgLinearGradient(ctx, 24, 36, 40, 48, nvgRGB(255, 255, 0),
+		nvgRGB(0, 255, 255)));
+	nvgFill(ctx);
+}
+
+// The pixels of a frame are read back into memory.
+void checkReadback(const vpp::Device& dev)
+{
+	vvg::RendererSettings settings;
+	settings.framesInFlight = 2;
+	auto ctx = create(dev, settings);
+
+	auto first = offscreen(ctx).nextFrame();
+	frame(ctx, [](NVGcontext* ctx){ rect(ctx, 0, 0, 32, size, nvgRGB(255, 0, 0)); });
+	auto second = offscreen(ctx).nextFrame();
+	frame(ctx, [](NVGcontext* ctx){ rect(ctx, 0, 0, 32, size, nvgRGB(0, 0, 255)); });
+	offscreen(ctx).wait();
+
+	auto a = first.get();
+	auto b = second.get();
+	check(a.size.width == size && a.size.height == size, "readback: image size");
+	check(a.data.size() == size * size * 4, "readback: data size");
+	check(b.frame == a.frame + 1, "readback: frames are delivered in order");
+
+	auto left = pixel(a.data, 8, 8);
+	auto right = pixel(a.data, 56, 8);
+	check(left[0] == 255 && left[1] == 0 && left[2] == 0 && left[3] == 255,
+		"readback: filled pixel");
+	check(right[0] == 0 && right[1] == 0 && right[2] == 0 && right[3] == 255,
+		"readback: cleared pixel");
+	check(pixel(b.data, 8, 8)[2] == 255, "readback: second frame");
+
+	vvg::destroyContext(*ctx);
+}
+
+// Indexed geometry converts fans and strips into triangle lists, the result must match.
+void checkIndexedGeometry(const vpp::Device& dev)
+{
+	auto plain = create(dev);
+	auto expected = render(plain, shapes);
+	vvg::destroyContext(*plain);
+
+	vvg::RendererSettings settings;
+	settings.indexedGeometry = true;
+	auto indexed = create(dev, settings);
+	check(similar(render(indexed, shapes), expected), "indexedGeometry: same pixels");
+	vvg::destroyContext(*indexed);
+}
+
+// Packed vertices lose no precision on their grid and clamp positions outside their range.
+// The rectangles and their fringes lie on the grid of 1/4 pixels.
+void checkPackedVertices(const vpp::Device& dev)
+{
+	auto rects = [](NVGcontext* ctx){
+		rect(ctx, 4, 4, 24, 24, nvgRGB(255, 0, 0));
+		rect(ctx, 20.25f, 16.5f, 30.75f, 40, nvgRGBA(0, 255, 0, 128));
+	};
+
+	auto plain = create(dev);
+	auto expected = render(plain, rects);
+	vvg::destroyContext(*plain);
+
+	vvg::RendererSettings settings;
+	settings.packedVertices = 4;
+	auto packed = create(dev, settings);
+	check(similar(render(packed, rects), expected), "packedVertices: same pixels");
+
+	// wrapped instead of clamped positions would not cover the target
+	auto pixels = render(packed, [](NVGcontext* ctx){
+		rect(ctx, -20000, -20000, 40000, 40000, nvgRGB(255, 0, 0));
+	});
+
+	auto covered = true;
+	for(auto y = 0u; y < size; ++y)
+		for(auto x = 0u; x < size; ++x)
+			covered &= (pixel(pixels, x, y)[0] == 255);
+	check(covered, "packedVertices: out of range positions are clamped");
+
+	vvg::destroyContext(*packed);
+}
+
+// Draws with the same state are merged, fills are counted by kind.
+void checkStats(const vpp::Device& dev)
+{
+	auto ctx = create(dev);
+	auto& stats = offscreen(ctx).stats();
+
+	render(ctx, [](NVGcontext* ctx){
+		rect(ctx, 0, 0, 8, 8, nvgRGB(255, 0, 0));
+		rect(ctx, 16, 0, 8, 8, nvgRGB(255, 0, 0));
+		rect(ctx, 32, 0, 8, 8, nvgRGB(0, 255, 0));
+	});
+	check(stats.mergedDraws == 1, "stats: draws with the same state are merged");
+	check(stats.draws == 2, "stats: merged draw count");
+	check(stats.convexFills == 3 && stats.stencilFills == 0, "stats: convex fills");
+
+	render(ctx, shapes);
+	check(stats.stencilFills == 1, "stats: stencil fills");
+
+	vvg::destroyContext(*ctx);
+}
+
+// Recordings are reused while the structure hash is unchanged.
+void checkRecordingReuse(const vpp::Device& dev)
+{
+	auto ctx = create(dev);
+	auto& stats = offscreen(ctx).stats();
+	auto red = [](NVGcontext* ctx){ rect(ctx, 8, 8, 16, 16, nvgRGB(255, 0, 0)); };
+	auto blue = [](NVGcontext* ctx){ rect(ctx, 8, 8, 16, 16, nvgRGB(0, 0, 255)); };
+
+	render(ctx, red);
+	check(stats.recordingsRecorded == 1, "structureHash: first frame is recorded");
+	render(ctx, red);
+	check(stats.recordingsReused == 1, "structureHash: identical frame is reused");
+
+	// only the uniform data changes
+	auto pixels = render(ctx, blue);
+	check(stats.recordingsReused == 1, "structureHash: changed color is reused");
+	check(pixel(pixels, 12, 12)[2] == 255, "structureHash: reused recording uses new data");
+
+	render(ctx, shapes);
+	check(stats.recordingsRecorded == 1, "structureHash: changed structure is recorded");
+
+	vvg::destroyContext(*ctx);
+}
+
+// Identical frames are elided, changes of the draws or texture contents are not.
+void checkElision(const vpp::Device& dev)
+{
+	vvg::RendererSettings settings;
+	settings.elideIdenticalFrames = true;
+	auto ctx = create(dev, settings);
+	auto& renderer = offscreen(ctx);
+
+	std::uint8_t data[4] = {255, 0, 0, 255};
+	auto image = nvgCreateImageRGBA(ctx, 1, 1, 0, data);
+	auto textured = [&](NVGcontext* ctx){
+		nvgBeginPath(ctx);
+		nvgRect(ctx, 0, 0, 16, 16);
+		nvgFillPaint(ctx, nvgImagePattern(ctx, 0, 0, 16, 16, 0, image, 1));
+		nvgFill(ctx);
+	};
+
+	frame(ctx, textured);
+	check(!renderer.frameElided(), "contentHash: first frame is rendered");
+	frame(ctx, textured);
+	check(renderer.frameElided(), "contentHash: identical frame is elided");
+
+	data[1] = 255;
+	nvgUpdateImage(ctx, image, data);
+	frame(ctx, textured);
+	check(!renderer.frameElided(), "contentHash: updated texture is rendered");
+
+	frame(ctx, [](NVGcontext* ctx){ rect(ctx, 0, 0, 16, 16, nvgRGB(0, 255, 0)); });
+	check(!renderer.frameElided(), "contentHash: changed frame is rendered");
+
+	renderer.wait();
+	nvgDeleteImage(ctx, image);
+	vvg::destroyContext(*ctx);
+}
+
+// Deleted handles become stale, the generation of a slot wraps around.
+void checkTextureSlots(const vpp::Device& dev)
+{
+	auto ctx = create(dev);
+	auto& renderer = vvg::getRenderer(*ctx);
+	std::uint8_t data[4] = {};
+
+	// the slot generation has 11 bits
+	constexpr auto generations = 1u << 11;
+	auto first = nvgCreateImageRGBA(ctx, 1, 1, 0, data);
+	auto previous = first;
+	auto positive = first > 0;
+	auto stale = true;
+	for(auto i = 1u; i < generations; ++i) {
+		nvgDeleteImage(ctx, previous);
+		stale &= (renderer.texture(previous) == nullptr);
+
+		auto id = nvgCreateImageRGBA(ctx, 1, 1, 0, data);
+		positive &= id > 0;
+		stale &= (id != previous);
+		previous = id;
+	}
+
+	check(positive, "texture slots: handles are positive");
+	check(stale, "texture slots: deleted handles are stale");
+
+	nvgDeleteImage(ctx, previous);
+	auto wrapped = nvgCreateImageRGBA(ctx, 1, 1, 0, data);
+	check(wrapped == first, "texture slots: generation wraps around");
+	check(renderer.texture(wrapped) != nullptr, "texture slots: wrapped handle is valid");
+
+	nvgDeleteImage(ctx, wrapped);
+	vvg::destroyContext(*ctx);
+}
+
+// Operations are drawn like the captured draw calls, empty ones draw nothing.
+void checkOperations(const vpp::Device& dev)
+{
+	auto ctx = create(dev);
+	auto& renderer = vvg::getRenderer(*ctx);
+
+	vvg::RenderOperation operation;
+	vvg::RenderOperation empty;
+	auto expected = render(ctx, [&](NVGcontext* ctx){
+		renderer.beginOperation(operation);
+		rect(ctx, 8, 8, 16, 16, nvgRGB(255, 0, 0));
+		renderer.endOperation();
+
+		renderer.beginOperation(empty);
+		renderer.endOperation();
+
+		rect(ctx, 8, 8, 16, 16, nvgRGB(255, 0, 0));
+	});
+
+	auto pixels = render(ctx, [&](NVGcontext*){
+		renderer.draw(operation);
+		renderer.draw(empty);
+	});
+	check(similar(pixels, expected), "operations: same pixels as the captured calls");
+
+	operation.position.set({{16.f, 0.f}});
+	pixels = render(ctx, [&](NVGcontext*){ renderer.draw(operation); });
+	check(pixel(pixels, 12, 12)[0] == 0 && pixel(pixels, 28, 12)[0] == 255,
+		"operations: position parameter");
+
+	renderer.wait();
+	vvg::destroyContext(*ctx);
+}
+
+} // anonymous namespace
+
+int main()
+{
+	//instance
+	vk::ApplicationInfo appInfo;
+	appInfo.pApplicationName = "vvg-checks";
+	appInfo.applicationVersion = 1;
+	appInfo.pEngineName = "vvg";
+	appInfo.engineVersion = 1;
+	appInfo.apiVersion = VK_MAKE_VERSION(1, 0, 21);
+
+	vk::InstanceCreateInfo iniinfo;
+	iniinfo.pApplicationInfo = &appInfo;
+
+	vpp::Instance instance(iniinfo);
+
+	//device
+	auto phdevs = vk::enumeratePhysicalDevices(instance);
+	auto queueProps = vk::getPhysicalDeviceQueueFamilyProperties(phdevs[0]);
+
+	const float prio = 0.0;
+	vk::DeviceQueueCreateInfo queueInfo;
+	queueInfo.queueCount = 1;
+	queueInfo.pQueuePriorities = &prio;
+	for(auto i = 0u; i < queueProps.size(); ++i)
+	{
+		queueInfo.queueFamilyIndex = i;
+		if(queueProps[i].queueFlags & vk::QueueBits::graphics) break;
+	}
+
+	vk::DeviceCreateInfo devinfo;
+	devinfo.queueCreateInfoCount = 1;
+	devinfo.pQueueCreateInfos = &queueInfo;
+
+	vpp::Device dev(instance, phdevs[0], devinfo);
+
+	checkReadback(dev);
+	checkIndexedGeometry(dev);
+	checkPackedVertices(dev);
+	checkStats(dev);
+	checkRecordingReuse(dev);
+	checkElision(dev);
+	checkTextureSlots(dev);
+	checkOperations(dev);
+
+	if(failed) {
+		std::printf("%u checks failed\n", failed);
+		return 1;
+	}
+
+	std::printf("all checks passed\n");
+}
@@ -0,0 +1,87 @@
+// Measures the time until the first frame of a nanovg context was rendered.
+// Run it twice to see the effect of the pipeline cache on the second start.
+
+#include <vvg.hpp>
+
+#include <vpp/device.hpp>
+#include <vpp/instance.hpp>
+#include <vpp/vk.hpp>
+
+#include <nanovg.h>
+
+#include <chrono>
+#include <memory>
+#include <cstdio>
+
+int main()
+{
+	using Clock = std::chrono::steady_clock;
+	auto ms = [](Clock::time_point from) {
+		return std::chrono::duration<double, std::milli>(Clock::now() - from).count();
+	};
+
+	//instance
+	vk::ApplicationInfo appInfo;
+	appInfo.pApplicationName = "vvg-startup";
+	appInfo.applicationVersion = 1;
+	appInfo.pEngineName = "vvg";
+	appInfo.engineVersion = 1;
+	appInfo.apiVersion = VK_MAKE_VERSION(1, 0, 21);
+
+	vk::InstanceCreateInfo iniinfo;
+	iniinfo.pApplicationInfo = &appInfo;
+
+	vpp::Instance instance(iniinfo);
+
+	//device
+	auto phdevs = vk::enumeratePhysicalDevices(instance);
+	auto queueProps = vk::getPhysicalDeviceQueueFamilyProperties(phdevs[0]);
+
+	const float prio = 0.0;
+	vk::DeviceQueueCreateInfo queueInfo;
+	queueInfo.queueCount = 1;
+	queueInfo.pQueuePriorities = &prio;
+	for(auto i = 0u; i < queueProps.size(); ++i)
+	{
+		queueInfo.queueFamilyIndex = i;
+		if(queueProps[i].queueFlags & vk::QueueBits::graphics) break;
+	}
+
+	vk::DeviceCreateInfo devinfo;
+	devinfo.queueCreateInfoCount = 1;
+	devinfo.pQueueCreateInfos = &queueInfo;
+
+	vpp::Device dev(instance, phdevs[0], devinfo);
+
+	//everything from here on is part of the startup time of an application
+	auto width = 1024u;
+	auto height = 1024u;
+	auto start = Clock::now();
+
+	auto renderer = std::make_unique<vvg::OffscreenRenderer>(dev, vk::Extent2D {width, height});
+	auto nvgContext = vvg::createContext(std::move(renderer));
+	auto contextTime = ms(start);
+
+	nvgBeginFrame(nvgContext, width, height, 1.f);
+
+	nvgBeginPath(nvgContext);
+	nvgRoundedRect(nvgContext, 100, 100, 400, 200, 20);
+	nvgFillColor(nvgContext, nvgRGBAf(0.5, 0.8, 0.7, 0.7));
+	nvgFill(nvgContext);
+
+	nvgBeginPath(nvgContext);
+	nvgMoveTo(nvgContext, 100, 400);
+	nvgBezierTo(nvgContext, 300, 300, 500, 600, 700, 400);
+	nvgStrokeColor(nvgContext, nvgRGBAf(0.9, 0.4, 0.2, 1.0));
+	nvgStrokeWidth(nvgContext, 8);
+	nvgStroke(nvgContext);
+
+	nvgEndFrame(nvgContext);
+	vvg::getRenderer(*nvgContext).wait();
+	auto frameTime = ms(start);
+
+	std::printf("context creation: %.2f ms\n", contextTime);
+	std::printf("time to first frame: %.2f ms\n", frameTime);
+
+	vvg::destroyContext(*nvgContext);
+}
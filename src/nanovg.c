@@ -107,6 +107,16 @@ struct NVGpathCache {
 };
 typedef struct NVGpathCache NVGpathCache;
 
+// Font atlas, may be shared by multiple contexts whose renderers share their textures.
+struct NVGfontAtlas {
+	struct FONScontext* fs;
+	int images[NVG_MAX_FONTIMAGES];
+	int imageIdx;
+	int refCount;
+	int openFrames; // frames of the sharing contexts that are not ended yet
+};
+typedef struct NVGfontAtlas NVGfontAtlas;
+
 struct NVGcontext {
 	NVGparams params;
 	float* commands;
@@ -120,9 +130,8 @@ struct NVGcontext {
 	float distTol;
 	float fringeWidth;
 	float devicePxRatio;
-	struct FONScontext* fs;
-	int fontImages[NVG_MAX_FONTIMAGES];
-	int fontImageIdx;
+	NVGfontAtlas* fonts;
+	int frameOpen;
 	int drawCallCount;
 	int fillTriCount;
 	int strokeTriCount;
@@ -204,16 +213,18 @@ static void nvg__setDevicePixelRatio(NVGcontext* ctx, float ratio)
 }
 
 NVGcontext* nvgCreateInternal(NVGparams* params)
+{
+	return nvgCreateInternalShared(params, NULL);
+}
+
+NVGcontext* nvgCreateInternalShared(NVGparams* params, NVGcontext* fontContext)
 {
 	FONSparams fontParams;
 	NVGcontext* ctx = (NVGcontext*)malloc(sizeof(NVGcontext));
-	int i;
 	if (ctx == NULL) goto error;
 	memset(ctx, 0, sizeof(NVGcontext));
 
 	ctx->params = *params;
-	for (i = 0; i < NVG_MAX_FONTIMAGES; i++)
-		ctx->fontImages[i] = 0;
 
 	ctx->commands = (float*)malloc(sizeof(float)*NVG_INIT_COMMANDS_SIZE);
 	if (!ctx->commands) goto error;
@@ -230,6 +241,18 @@ NVGcontext* nvgCreateInternal(NVGparams* params)
 
 	if (ctx->params.renderCreate(ctx->params.userPtr) == 0) goto error;
 
+	// Share the font atlas of the given context
+	if (fontContext != NULL) {
+		ctx->fonts = fontContext->fonts;
+		ctx->fonts->refCount++;
+		return ctx;
+	}
+
+	ctx->fonts = (NVGfontAtlas*)malloc(sizeof(NVGfontAtlas));
+	if (ctx->fonts == NULL) goto error;
+	memset(ctx->fonts, 0, sizeof(NVGfontAtlas));
+	ctx->fonts->refCount = 1;
+
 	// Init font rendering
 	memset(&fontParams, 0, sizeof(fontParams));
 	fontParams.width = NVG_INIT_FONTIMAGE_SIZE;
@@ -240,13 +263,13 @@ NVGcontext* nvgCreateInternal(NVGparams* params)
 	fontParams.renderDraw = NULL;
 	fontParams.renderDelete = NULL;
 	fontParams.userPtr = NULL;
-	ctx->fs = fonsCreateInternal(&fontParams);
-	if (ctx->fs == NULL) goto error;
+	ctx->fonts->fs = fonsCreateInternal(&fontParams);
+	if (ctx->fonts->fs == NULL) goto error;
 
 	// Create font texture
-	ctx->fontImages[0] = ctx->params.renderCreateTexture(ctx->params.userPtr, NVG_TEXTURE_ALPHA, fontParams.width, fontParams.height, 0, NULL);
-	if (ctx->fontImages[0] == 0) goto error;
-	ctx->fontImageIdx = 0;
+	ctx->fonts->images[0] = ctx->params.renderCreateTexture(ctx->params.userPtr, NVG_TEXTURE_ALPHA, fontParams.width, fontParams.height, 0, NULL);
+	if (ctx->fonts->images[0] == 0) goto error;
+	ctx->fonts->imageIdx = 0;
 
 	return ctx;
 
@@ -266,15 +289,22 @@ void nvgDeleteInternal(NVGcontext* ctx)
 	if (ctx == NULL) return;
 	if (ctx->commands != NULL) free(ctx->commands);
 	if (ctx->cache != NULL) nvg__deletePathCache(ctx->cache);
-
-	if (ctx->fs)
-		fonsDeleteInternal(ctx->fs);
-
-	for (i = 0; i < NVG_MAX_FONTIMAGES; i++) {
-		if (ctx->fontImages[i] != 0) {
-			nvgDeleteImage(ctx, ctx->fontImages[i]);
-			ctx->fontImages[i] = 0;
+	if (ctx->fonts != NULL && ctx->frameOpen)
+		ctx->fonts->openFrames--;
+
+	// The font atlas is deleted with the last context sharing it
+	if (ctx->fonts != NULL && --ctx->fonts->refCount == 0) {
+		if (ctx->fonts->fs)
+			fonsDeleteInternal(ctx->fonts->fs);
+
+		for (i = 0; i < NVG_MAX_FONTIMAGES; i++) {
+			if (ctx->fonts->images[i] != 0) {
+				nvgDeleteImage(ctx, ctx->fonts->images[i]);
+				ctx->fonts->images[i] = 0;
+			}
 		}
+
+		free(ctx->fonts);
 	}
 
 	if (ctx->params.renderDelete != NULL)
@@ -293,6 +323,11 @@ void nvgBeginFrame(NVGcontext* ctx, int windowWidth, int windowHeight, float dev
 	nvgSave(ctx);
 	nvgReset(ctx);
 
+	if (!ctx->frameOpen) {
+		ctx->frameOpen = 1;
+		ctx->fonts->openFrames++;
+	}
+
 	nvg__setDevicePixelRatio(ctx, devicePixelRatio);
 
 	ctx->params.renderViewport(ctx->params.userPtr, windowWidth, windowHeight);
@@ -306,35 +341,47 @@ void nvgBeginFrame(NVGcontext* ctx, int windowWidth, int windowHeight, float dev
 void nvgCancelFrame(NVGcontext* ctx)
 {
 	ctx->params.renderCancel(ctx->params.userPtr);
+	if (ctx->frameOpen) {
+		ctx->frameOpen = 0;
+		ctx->fonts->openFrames--;
+	}
 }
 
 void nvgEndFrame(NVGcontext* ctx)
 {
 	ctx->params.renderFlush(ctx->params.userPtr);
-	if (ctx->fontImageIdx != 0) {
-		int fontImage = ctx->fontImages[ctx->fontImageIdx];
+	if (ctx->frameOpen) {
+		ctx->frameOpen = 0;
+		ctx->fonts->openFrames--;
+	}
+
+	// Another context sharing the atlas (e.g. the outer frame around a nested
+	// layer frame) may still reference the old font images. They are compacted
+	// by the last frame that ends.
+	if (ctx->fonts->imageIdx != 0 && ctx->fonts->openFrames == 0) {
+		int fontImage = ctx->fonts->images[ctx->fonts->imageIdx];
 		int i, j, iw, ih;
 		// delete images that smaller than current one
 		if (fontImage == 0)
 			return;
 		nvgImageSize(ctx, fontImage, &iw, &ih);
-		for (i = j = 0; i < ctx->fontImageIdx; i++) {
-			if (ctx->fontImages[i] != 0) {
+		for (i = j = 0; i < ctx->fonts->imageIdx; i++) {
+			if (ctx->fonts->images[i] != 0) {
 				int nw, nh;
-				nvgImageSize(ctx, ctx->fontImages[i], &nw, &nh);
+				nvgImageSize(ctx, ctx->fonts->images[i], &nw, &nh);
 				if (nw < iw || nh < ih)
-					nvgDeleteImage(ctx, ctx->fontImages[i]);
+					nvgDeleteImage(ctx, ctx->fonts->images[i]);
 				else
-					ctx->fontImages[j++] = ctx->fontImages[i];
+					ctx->fonts->images[j++] = ctx->fonts->images[i];
 			}
 		}
 		// make current font image to first
-		ctx->fontImages[j++] = ctx->fontImages[0];
-		ctx->fontImages[0] = fontImage;
-		ctx->fontImageIdx = 0;
+		ctx->fonts->images[j++] = ctx->fonts->images[0];
+		ctx->fonts->images[0] = fontImage;
+		ctx->fonts->imageIdx = 0;
 		// clear all images after j
 		for (i = j; i < NVG_MAX_FONTIMAGES; i++)
-			ctx->fontImages[i] = 0;
+			ctx->fonts->images[i] = 0;
 	}
 }
 
@@ -2087,6 +2134,12 @@ void nvgDebugDumpPathCache(NVGcontext* ctx)
 	}
 }
 
+static void nvg__tessellation(NVGcontext* ctx, int done)
+{
+	if (ctx->params.renderTessellation != NULL)
+		ctx->params.renderTessellation(ctx->params.userPtr, done);
+}
+
 void nvgFill(NVGcontext* ctx)
 {
 	NVGstate* state = nvg__getState(ctx);
@@ -2094,11 +2147,13 @@ void nvgFill(NVGcontext* ctx)
 	NVGpaint fillPaint = state->fill;
 	int i;
 
+	nvg__tessellation(ctx, 0);
 	nvg__flattenPaths(ctx);
 	if (ctx->params.edgeAntiAlias)
 		nvg__expandFill(ctx, ctx->fringeWidth, NVG_MITER, 2.4f);
 	else
 		nvg__expandFill(ctx, 0.0f, NVG_MITER, 2.4f);
+	nvg__tessellation(ctx, 1);
 
 	// Apply global alpha
 	fillPaint.innerColor.a *= state->alpha;
@@ -2138,12 +2193,14 @@ void nvgStroke(NVGcontext* ctx)
 	strokePaint.innerColor.a *= state->alpha;
 	strokePaint.outerColor.a *= state->alpha;
 
+	nvg__tessellation(ctx, 0);
 	nvg__flattenPaths(ctx);
 
 	if (ctx->params.edgeAntiAlias)
 		nvg__expandStroke(ctx, strokeWidth*0.5f + ctx->fringeWidth*0.5f, state->lineCap, state->lineJoin, state->miterLimit);
 	else
 		nvg__expandStroke(ctx, strokeWidth*0.5f, state->lineCap, state->lineJoin, state->miterLimit);
+	nvg__tessellation(ctx, 1);
 
 	ctx->params.renderStroke(ctx->params.userPtr, &strokePaint, &state->scissor, ctx->fringeWidth,
 							 strokeWidth, ctx->cache->paths, ctx->cache->npaths);
@@ -2159,18 +2216,18 @@ void nvgStroke(NVGcontext* ctx)
 // Add fonts
 int nvgCreateFont(NVGcontext* ctx, const char* name, const char* path)
 {
-	return fonsAddFont(ctx->fs, name, path);
+	return fonsAddFont(ctx->fonts->fs, name, path);
 }
 
 int nvgCreateFontMem(NVGcontext* ctx, const char* name, unsigned char* data, int ndata, int freeData)
 {
-	return fonsAddFontMem(ctx->fs, name, data, ndata, freeData);
+	return fonsAddFontMem(ctx->fonts->fs, name, data, ndata, freeData);
 }
 
 int nvgFindFont(NVGcontext* ctx, const char* name)
 {
 	if (name == NULL) return -1;
-	return fonsGetFontByName(ctx->fs, name);
+	return fonsGetFontByName(ctx->fonts->fs, name);
 }
 
 // State setting
@@ -2213,7 +2270,7 @@ void nvgFontFaceId(NVGcontext* ctx, int font)
 void nvgFontFace(NVGcontext* ctx, const char* font)
 {
 	NVGstate* state = nvg__getState(ctx);
-	state->fontId = fonsGetFontByName(ctx->fs, font);
+	state->fontId = fonsGetFontByName(ctx->fonts->fs, font);
 }
 
 static float nvg__quantize(float a, float d)
@@ -2230,12 +2287,12 @@ static void nvg__flushTextTexture(NVGcontext* ctx)
 {
 	int dirty[4];
 
-	if (fonsValidateTexture(ctx->fs, dirty)) {
-		int fontImage = ctx->fontImages[ctx->fontImageIdx];
+	if (fonsValidateTexture(ctx->fonts->fs, dirty)) {
+		int fontImage = ctx->fonts->images[ctx->fonts->imageIdx];
 		// Update texture
 		if (fontImage != 0) {
 			int iw, ih;
-			const unsigned char* data = fonsGetTextureData(ctx->fs, &iw, &ih);
+			const unsigned char* data = fonsGetTextureData(ctx->fonts->fs, &iw, &ih);
 			int x = dirty[0];
 			int y = dirty[1];
 			int w = dirty[2] - dirty[0];
@@ -2249,23 +2306,23 @@ static int nvg__allocTextAtlas(NVGcontext* ctx)
 {
 	int iw, ih;
 	nvg__flushTextTexture(ctx);
-	if (ctx->fontImageIdx >= NVG_MAX_FONTIMAGES-1)
+	if (ctx->fonts->imageIdx >= NVG_MAX_FONTIMAGES-1)
 		return 0;
 	// if next fontImage already have a texture
-	if (ctx->fontImages[ctx->fontImageIdx+1] != 0)
-		nvgImageSize(ctx, ctx->fontImages[ctx->fontImageIdx+1], &iw, &ih);
+	if (ctx->fonts->images[ctx->fonts->imageIdx+1] != 0)
+		nvgImageSize(ctx, ctx->fonts->images[ctx->fonts->imageIdx+1], &iw, &ih);
 	else { // calculate the new font image size and create it.
-		nvgImageSize(ctx, ctx->fontImages[ctx->fontImageIdx], &iw, &ih);
+		nvgImageSize(ctx, ctx->fonts->images[ctx->fonts->imageIdx], &iw, &ih);
 		if (iw > ih)
 			ih *= 2;
 		else
 			iw *= 2;
 		if (iw > NVG_MAX_FONTIMAGE_SIZE || ih > NVG_MAX_FONTIMAGE_SIZE)
 			iw = ih = NVG_MAX_FONTIMAGE_SIZE;
-		ctx->fontImages[ctx->fontImageIdx+1] = ctx->params.renderCreateTexture(ctx->params.userPtr, NVG_TEXTURE_ALPHA, iw, ih, 0, NULL);
+		ctx->fonts->images[ctx->fonts->imageIdx+1] = ctx->params.renderCreateTexture(ctx->params.userPtr, NVG_TEXTURE_ALPHA, iw, ih, 0, NULL);
 	}
-	++ctx->fontImageIdx;
-	fonsResetAtlas(ctx->fs, iw, ih);
+	++ctx->fonts->imageIdx;
+	fonsResetAtlas(ctx->fonts->fs, iw, ih);
 	return 1;
 }
 
@@ -2275,7 +2332,7 @@ static void nvg__renderText(NVGcontext* ctx, NVGvertex* verts, int nverts)
 	NVGpaint paint = state->fill;
 
 	// Render triangles.
-	paint.image = ctx->fontImages[ctx->fontImageIdx];
+	paint.image = ctx->fonts->images[ctx->fonts->imageIdx];
 
 	// Apply global alpha
 	paint.innerColor.a *= state->alpha;
@@ -2303,19 +2360,20 @@ float nvgText(NVGcontext* ctx, float x, float y, const char* string, const char*
 
 	if (state->fontId == FONS_INVALID) return x;
 
-	fonsSetSize(ctx->fs, state->fontSize*scale);
-	fonsSetSpacing(ctx->fs, state->letterSpacing*scale);
-	fonsSetBlur(ctx->fs, state->fontBlur*scale);
-	fonsSetAlign(ctx->fs, state->textAlign);
-	fonsSetFont(ctx->fs, state->fontId);
+	fonsSetSize(ctx->fonts->fs, state->fontSize*scale);
+	fonsSetSpacing(ctx->fonts->fs, state->letterSpacing*scale);
+	fonsSetBlur(ctx->fonts->fs, state->fontBlur*scale);
+	fonsSetAlign(ctx->fonts->fs, state->textAlign);
+	fonsSetFont(ctx->fonts->fs, state->fontId);
 
 	cverts = nvg__maxi(2, (int)(end - string)) * 6; // conservative estimate.
 	verts = nvg__allocTempVerts(ctx, cverts);
 	if (verts == NULL) return x;
 
-	fonsTextIterInit(ctx->fs, &iter, x*scale, y*scale, string, end);
+	nvg__tessellation(ctx, 0);
+	fonsTextIterInit(ctx->fonts->fs, &iter, x*scale, y*scale, string, end);
 	prevIter = iter;
-	while (fonsTextIterNext(ctx->fs, &iter, &q)) {
+	while (fonsTextIterNext(ctx->fonts->fs, &iter, &q)) {
 		float c[4*2];
 		if (iter.prevGlyphIndex == -1) { // can not retrieve glyph?
 			if (!nvg__allocTextAtlas(ctx))
@@ -2325,7 +2383,7 @@ float nvgText(NVGcontext* ctx, float x, float y, const char* string, const char*
 				nverts = 0;
 			}
 			iter = prevIter;
-			fonsTextIterNext(ctx->fs, &iter, &q); // try again
+			fonsTextIterNext(ctx->fonts->fs, &iter, &q); // try again
 			if (iter.prevGlyphIndex == -1) // still can not find glyph?
 				break;
 		}
@@ -2345,6 +2403,7 @@ float nvgText(NVGcontext* ctx, float x, float y, const char* string, const char*
 			nvg__vset(&verts[nverts], c[4], c[5], q.s1, q.t1); nverts++;
 		}
 	}
+	nvg__tessellation(ctx, 1);
 
 	// TODO: add back-end bit to do this just once per frame.
 	nvg__flushTextTexture(ctx);
@@ -2404,18 +2463,18 @@ int nvgTextGlyphPositions(NVGcontext* ctx, float x, float y, const char* string,
 	if (string == end)
 		return 0;
 
-	fonsSetSize(ctx->fs, state->fontSize*scale);
-	fonsSetSpacing(ctx->fs, state->letterSpacing*scale);
-	fonsSetBlur(ctx->fs, state->fontBlur*scale);
-	fonsSetAlign(ctx->fs, state->textAlign);
-	fonsSetFont(ctx->fs, state->fontId);
+	fonsSetSize(ctx->fonts->fs, state->fontSize*scale);
+	fonsSetSpacing(ctx->fonts->fs, state->letterSpacing*scale);
+	fonsSetBlur(ctx->fonts->fs, state->fontBlur*scale);
+	fonsSetAlign(ctx->fonts->fs, state->textAlign);
+	fonsSetFont(ctx->fonts->fs, state->fontId);
 
-	fonsTextIterInit(ctx->fs, &iter, x*scale, y*scale, string, end);
+	fonsTextIterInit(ctx->fonts->fs, &iter, x*scale, y*scale, string, end);
 	prevIter = iter;
-	while (fonsTextIterNext(ctx->fs, &iter, &q)) {
+	while (fonsTextIterNext(ctx->fonts->fs, &iter, &q)) {
 		if (iter.prevGlyphIndex < 0 && nvg__allocTextAtlas(ctx)) { // can not retrieve glyph?
 			iter = prevIter;
-			fonsTextIterNext(ctx->fs, &iter, &q); // try again
+			fonsTextIterNext(ctx->fonts->fs, &iter, &q); // try again
 		}
 		prevIter = iter;
 		positions[npos].str = iter.str;
@@ -2467,20 +2526,20 @@ int nvgTextBreakLines(NVGcontext* ctx, const char* string, const char* end, floa
 
 	if (string == end) return 0;
 
-	fonsSetSize(ctx->fs, state->fontSize*scale);
-	fonsSetSpacing(ctx->fs, state->letterSpacing*scale);
-	fonsSetBlur(ctx->fs, state->fontBlur*scale);
-	fonsSetAlign(ctx->fs, state->textAlign);
-	fonsSetFont(ctx->fs, state->fontId);
+	fonsSetSize(ctx->fonts->fs, state->fontSize*scale);
+	fonsSetSpacing(ctx->fonts->fs, state->letterSpacing*scale);
+	fonsSetBlur(ctx->fonts->fs, state->fontBlur*scale);
+	fonsSetAlign(ctx->fonts->fs, state->textAlign);
+	fonsSetFont(ctx->fonts->fs, state->fontId);
 
 	breakRowWidth *= scale;
 
-	fonsTextIterInit(ctx->fs, &iter, 0, 0, string, end);
+	fonsTextIterInit(ctx->fonts->fs, &iter, 0, 0, string, end);
 	prevIter = iter;
-	while (fonsTextIterNext(ctx->fs, &iter, &q)) {
+	while (fonsTextIterNext(ctx->fonts->fs, &iter, &q)) {
 		if (iter.prevGlyphIndex < 0 && nvg__allocTextAtlas(ctx)) { // can not retrieve glyph?
 			iter = prevIter;
-			fonsTextIterNext(ctx->fs, &iter, &q); // try again
+			fonsTextIterNext(ctx->fonts->fs, &iter, &q); // try again
 		}
 		prevIter = iter;
 		switch (iter.codepoint) {
@@ -2643,16 +2702,16 @@ float nvgTextBounds(NVGcontext* ctx, float x, float y, const char* string, const
 
 	if (state->fontId == FONS_INVALID) return 0;
 
-	fonsSetSize(ctx->fs, state->fontSize*scale);
-	fonsSetSpacing(ctx->fs, state->letterSpacing*scale);
-	fonsSetBlur(ctx->fs, state->fontBlur*scale);
-	fonsSetAlign(ctx->fs, state->textAlign);
-	fonsSetFont(ctx->fs, state->fontId);
+	fonsSetSize(ctx->fonts->fs, state->fontSize*scale);
+	fonsSetSpacing(ctx->fonts->fs, state->letterSpacing*scale);
+	fonsSetBlur(ctx->fonts->fs, state->fontBlur*scale);
+	fonsSetAlign(ctx->fonts->fs, state->textAlign);
+	fonsSetFont(ctx->fonts->fs, state->fontId);
 
-	width = fonsTextBounds(ctx->fs, x*scale, y*scale, string, end, bounds);
+	width = fonsTextBounds(ctx->fonts->fs, x*scale, y*scale, string, end, bounds);
 	if (bounds != NULL) {
 		// Use line bounds for height.
-		fonsLineBounds(ctx->fs, y*scale, &bounds[1], &bounds[3]);
+		fonsLineBounds(ctx->fonts->fs, y*scale, &bounds[1], &bounds[3]);
 		bounds[0] *= invscale;
 		bounds[1] *= invscale;
 		bounds[2] *= invscale;
@@ -2687,12 +2746,12 @@ void nvgTextBoxBounds(NVGcontext* ctx, float x, float y, float breakRowWidth, co
 	minx = maxx = x;
 	miny = maxy = y;
 
-	fonsSetSize(ctx->fs, state->fontSize*scale);
-	fonsSetSpacing(ctx->fs, state->letterSpacing*scale);
-	fonsSetBlur(ctx->fs, state->fontBlur*scale);
-	fonsSetAlign(ctx->fs, state->textAlign);
-	fonsSetFont(ctx->fs, state->fontId);
-	fonsLineBounds(ctx->fs, 0, &rminy, &rmaxy);
+	fonsSetSize(ctx->fonts->fs, state->fontSize*scale);
+	fonsSetSpacing(ctx->fonts->fs, state->letterSpacing*scale);
+	fonsSetBlur(ctx->fonts->fs, state->fontBlur*scale);
+	fonsSetAlign(ctx->fonts->fs, state->textAlign);
+	fonsSetFont(ctx->fonts->fs, state->fontId);
+	fonsLineBounds(ctx->fonts->fs, 0, &rminy, &rmaxy);
 	rminy *= invscale;
 	rmaxy *= invscale;
 
@@ -2738,13 +2797,13 @@ void nvgTextMetrics(NVGcontext* ctx, float* ascender, float* descender, float* l
 
 	if (state->fontId == FONS_INVALID) return;
 
-	fonsSetSize(ctx->fs, state->fontSize*scale);
-	fonsSetSpacing(ctx->fs, state->letterSpacing*scale);
-	fonsSetBlur(ctx->fs, state->fontBlur*scale);
-	fonsSetAlign(ctx->fs, state->textAlign);
-	fonsSetFont(ctx->fs, state->fontId);
+	fonsSetSize(ctx->fonts->fs, state->fontSize*scale);
+	fonsSetSpacing(ctx->fonts->fs, state->letterSpacing*scale);
+	fonsSetBlur(ctx->fonts->fs, state->fontBlur*scale);
+	fonsSetAlign(ctx->fonts->fs, state->textAlign);
+	fonsSetFont(ctx->fonts->fs, state->fontId);
 
-	fonsVertMetrics(ctx->fs, ascender, descender, lineh);
+	fonsVertMetrics(ctx->fonts->fs, ascender, descender, lineh);
 	if (ascender != NULL)
 		*ascender *= invscale;
 	if (descender != NULL)
@@ -595,11 +595,17 @@ struct NVGparams {
 	void (*renderStroke)(void* uptr, NVGpaint* paint, NVGscissor* scissor, float fringe, float strokeWidth, const NVGpath* paths, int npaths);
 	void (*renderTriangles)(void* uptr, NVGpaint* paint, NVGscissor* scissor, const NVGvertex* verts, int nverts);
 	void (*renderDelete)(void* uptr);
+	// Optional, called with done = 0 before and done = 1 after paths or text are tessellated.
+	void (*renderTessellation)(void* uptr, int done);
 };
 typedef struct NVGparams NVGparams;
 
 // Constructor and destructor, called by the render back-end.
 NVGcontext* nvgCreateInternal(NVGparams* params);
+
+// Creates a context that shares the fonts and font atlas of the given context.
+// The textures of both contexts must be shared by their render back-ends.
+NVGcontext* nvgCreateInternalShared(NVGparams* params, NVGcontext* fontContext);
 void nvgDeleteInternal(NVGcontext* ctx);
 
 NVGparams* nvgInternalParams(NVGcontext* ctx);
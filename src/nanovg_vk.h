@@ -30,6 +30,12 @@ NVGcontext* vvgCreate(const VVGContextDescription* description);
 /// Destroys the given nanovg context.
 void vvgDestroy(const NVGcontext* ctx);
 
+/// Makes the given context created with vvgCreate render on the given swapchain, which
+/// must have the same format as the previous one. Must be called after the swapchain was
+/// recreated (e.g. because the window was resized). Textures, pipelines and fonts are kept.
+/// Waits until the old swapchain is no longer used, so it can be destroyed afterwards.
+void vvgResize(NVGcontext* ctx, VkSwapchainKHR swapchain, VkExtent2D size);
+
 #ifdef __cplusplus
 } //extern C
 #endif
@@ -4,6 +4,7 @@
 
 // vpp
 #include <vpp/bufferOps.hpp>
+#include <vpp/commandBuffer.hpp>
 #include <vpp/pipeline.hpp>
 #include <vpp/swapchain.hpp>
 #include <vpp/framebuffer.hpp>
@@ -20,6 +21,11 @@
 #include <cstring>
 #include <algorithm>
 #include <iterator>
+#include <cstdio>
+#include <cmath>
+#include <chrono>
+#include <list>
+#include <atomic>
 
 // shader header
 #include "shader/fill.frag.h"
@@ -29,6 +35,8 @@ namespace vvg {
 
 template<typename... T> constexpr void unused(T&&...) {}
 
+using Clock = std::chrono::steady_clock;
+
 // minimal shader typedefs
 struct Vec2 { float x,y; };
 struct Vec3 { float x,y,z; };
@@ -38,16 +46,77 @@ using Mat2 = float[2][2];
 using Mat3 = float[3][3];
 using Mat4 = float[4][4];
 
+// texture handles store the slot index + 1 in the lower bits and the slot generation
+// in the upper bits. The handles must stay positive since nanovg uses int.
+constexpr auto textureIndexBits = 20u;
+constexpr auto textureIndexMask = (1u << textureIndexBits) - 1;
+constexpr auto textureGenerationMask = (1u << 11) - 1;
+constexpr auto maxTextures = textureIndexMask;
+
+// the minimum number of draws a chunk recorded on its own thread has
+constexpr auto minRecordChunkSize = 256u;
+
+// last capture version assigned to a RenderOperation, unique over all renderers
+std::atomic<std::uint64_t> operationVersion {0};
+
+// paint types and texture formats, must match the TYPE_* and TEXTYPE_* macros in fill.frag
+constexpr auto typeColor = 1u;
+constexpr auto typeGradient = 2u;
+constexpr auto typeTexture = 3u;
+
+constexpr auto texTypeRGBA = 1u;
+constexpr auto texTypeA = 2u;
+constexpr auto texTypePremultiplied = 3u;
+
+// timestamp queries of a frame with gpuTimings: start and end of the frame, end of the
+// draws and the start of every group of consecutive draws of the same kind
+constexpr auto queryFrameStart = 0u;
+constexpr auto queryFrameEnd = 1u;
+constexpr auto queryDrawsEnd = 2u;
+constexpr auto queryFirstGroup = 3u;
+constexpr auto maxTimestampGroups = 256u;
+constexpr auto timestampQueryCount = queryFirstGroup + maxTimestampGroups;
+
+// fragment shader variants, see the specialization constants in fill.frag
+// bits 0-1: paint type, bits 2-3: texture format, bit 4: scissor, bit 5: stroke antialiasing.
+// Bit 6 is no shader variant, it blends the destination alpha (see Renderer::blendAlpha_)
+constexpr auto variantScissor = 1u << 4;
+constexpr auto variantStrokeAA = 1u << 5;
+constexpr auto variantBlendAlpha = 1u << 6;
+
 struct UniformData {
 	Vec2 viewSize;
 	std::uint32_t type;
-	std::uint32_t texType;
+	std::uint32_t texType; // format | (texture array slot << 8)
 	Vec4 innerColor;
 	Vec4 outerColor;
 	Mat4 scissorMat;
 	Mat4 paintMat;
 };
 
+// Compact version of UniformData that is used in the push constant mode.
+// Must match the PushConstants block in the shaders and fit into 128 bytes.
+struct PushData {
+	Vec4 scissorMat; // upper 2x2 part of scissorMat
+	Vec4 scissorTranslateExtent; // scissorMat translation, scissor extent
+	Vec4 scissorScaleViewSize; // scissor scale, viewSize
+	Vec4 paintMat; // upper 2x2 part of paintMat
+	Vec4 paintTranslateExtent; // paintMat translation, paint extent
+	float params[3]; // radius, feather, strokeMult
+	std::uint32_t typeBits; // type | (texType << 8)
+	std::uint32_t colors[4]; // innerColor, outerColor as packed half floats
+	Vec4 transform; // translation, scale of the vertices
+};
+
+static_assert(sizeof(PushData) == 128, "PushData exceeds the push constant limit");
+
+// Vertex format used with the packedVertices setting.
+// The position is a snorm value scaled by 32767 / packedVertices in the vertex shader.
+struct PackedVertex {
+	std::int16_t x, y;
+	std::uint16_t u, v;
+};
+
 struct Path {
 	std::size_t fillOffset = 0;
 	std::size_t fillCount = 0;
@@ -55,14 +124,161 @@ struct Path {
 	std::size_t strokeCount = 0;
 };
 
+// The kind of nanovg call a draw was created by, used to attribute device time.
+enum DrawKind : std::uint8_t {
+	drawFill,
+	drawStroke,
+	drawTriangles,
+};
+
 struct DrawData {
-	vpp::DescriptorSet descriptorSet;
 	UniformData uniformData;
+	std::uint32_t uniformOffset = 0; // dynamic offset into the frames uniform buffer
 	unsigned int texture = 0;
+	RenderOperation* operation = nullptr; // if not null, draws the operation instead
+	std::uint32_t variant = 0; // paint type, texture format and scissor bits of the variant
+	DrawKind kind = drawFill;
 
 	std::vector<Path> paths;
 	std::size_t triangleOffset = 0;
 	std::size_t triangleCount = 0;
+
+	// fills that are not a single convex path are drawn using the stencil buffer
+	// the paths are drawn into the stencil, then the bounds quad is used to cover them
+	bool stencilFill = false;
+	std::size_t coverOffset = 0; // 4 vertices, triangle strip
+
+	// only used with indexedGeometry, contains all paths and triangles
+	// for stencil fills the stencil fans, fringes and the cover quad follow each other
+	std::uint32_t indexOffset = 0;
+	std::uint32_t indexCount = 0;
+	std::uint32_t stencilIndexCount = 0;
+	std::uint32_t fringeIndexCount = 0;
+};
+
+// Region of a texture that is uploaded with the next frame.
+struct TextureUpload {
+	unsigned int texture;
+	vk::Offset2D offset;
+	vk::Extent2D extent;
+	std::size_t dataOffset; // offset in SharedResources::uploadData_
+};
+
+// Timestamp query pool of a frame, only created with gpuTimings.
+class TimestampPool {
+public:
+	TimestampPool() = default;
+	TimestampPool(vk::Device dev, unsigned int count) : device_(dev)
+	{
+		vk::QueryPoolCreateInfo info;
+		info.queryType = vk::QueryType::timestamp;
+		info.queryCount = count;
+		pool_ = vk::createQueryPool(dev, info);
+	}
+
+	~TimestampPool() { if(pool_) vk::destroyQueryPool(device_, pool_); }
+
+	TimestampPool(TimestampPool&& other) noexcept { swap(other); }
+	TimestampPool& operator=(TimestampPool other) noexcept { swap(other); return *this; }
+
+	void swap(TimestampPool& other) noexcept
+	{
+		std::swap(device_, other.device_);
+		std::swap(pool_, other.pool_);
+	}
+
+	operator vk::QueryPool() const { return pool_; }
+
+protected:
+	vk::Device device_ {};
+	vk::QueryPool pool_ {};
+};
+
+// Resources that are used by a single frame in flight.
+// The Renderer cycles through a ring of them so that the resources of frames that are
+// still processed by the device are never touched.
+struct RenderFrame {
+	vpp::Buffer uniformBuffer;
+	vpp::Buffer vertexBuffer;
+	vpp::Buffer indexBuffer; // only used with indexedGeometry
+	vk::IndexType indexType {};
+	vpp::DescriptorPool descriptorPool;
+	vpp::DescriptorSet uniformSet; // dynamic uniform buffer descriptor for uniformBuffer
+	vpp::DescriptorSet textureArraySet; // only used if textureArraySize is not 0
+	unsigned int textureArrayVersion {}; // version of the textures in textureArraySet
+	vpp::CommandBuffer commandBuffer; // only used if rendering into a framebuffer
+	std::vector<vpp::CommandPool> recordPools; // one per chunk, recorded in parallel
+	std::vector<vpp::CommandBuffer> recordBuffers; // secondary buffers for the chunks
+	vpp::Buffer uploadBuffer; // staging buffer for texture uploads
+	vpp::CommandBuffer uploadCommandBuffer; // submitted before the frame if there are uploads
+	TimestampPool timestampPool; // only used with gpuTimings
+	vpp::CommandBuffer timestampReset; // resets the pool before swapchain frames
+	std::vector<std::uint8_t> timestampGroups; // DrawKind of every measured group
+	std::uint64_t timedFrame {}; // number of the frame that wrote the timestamps, 0 if none
+	std::uint64_t resourceVersion {}; // changed whenever a buffer or set is recreated
+	std::uint64_t recordHash {}; // structure hash of the commandBuffer recording, 0 if none
+
+	vpp::CommandExecutionState state; // execution state of the last submission
+	bool submitted {}; // whether the frame was submitted and not yet waited for
+	// textures that were deleted before the last submission
+	std::vector<std::shared_ptr<TextureGarbage>> garbage;
+};
+
+// A deleted texture that frames in flight of the renderers sharing it may still use.
+// Destroyed once all of them are finished, its descriptor set can then be reused.
+struct TextureGarbage {
+	std::shared_ptr<SharedResources> shared;
+	Texture texture;
+	vpp::DescriptorSet descriptorSet; // not used if a texture array is used
+
+	~TextureGarbage()
+	{
+		if(descriptorSet)
+			shared->freeTextureSets_.push_back(std::move(descriptorSet));
+	}
+};
+
+// State of a recording, used to avoid redundant binds.
+struct RecordState {
+	std::int64_t pipeline = -1; // key of the bound pipeline
+	unsigned int pipelineBinds = 0;
+	unsigned int descriptorBinds = 0;
+	unsigned int drawCommands = 0;
+	bool textureBound = false;
+	unsigned int texture = 0;
+
+	vk::QueryPool timestamps {}; // if not null, the draw groups are measured
+	std::vector<std::uint8_t> groups; // DrawKind of every written group
+};
+
+// The pipelines used for drawing. The keys of the pipeline maps in SharedResources contain
+// the type in the lower bits and the fragment shader variant above them.
+// With indexed geometry only list and the fill pipelines are used.
+constexpr auto pipelineTypeBits = 3u;
+constexpr auto pipelineTypeMask = (1u << pipelineTypeBits) - 1;
+
+enum PipelineType : std::uint32_t {
+	pipelineFan,
+	pipelineStrip,
+	pipelineList,
+	pipelineFillStencil, // fill paths into the stencil buffer
+	pipelineFillFringe, // antialiased fringes outside of the stencil
+	pipelineFillCover, // cover the stencil, resets it
+};
+
+// Everything needed to create a pipeline. Only holds handles so that pipelines can
+// be created on another thread while the Renderer is used.
+struct PipelineContext {
+	vk::Device device;
+	vk::PipelineCache cache;
+	vk::PipelineLayout layout;
+	vk::RenderPass renderPass;
+	vk::ShaderModule vertexShader;
+	vk::ShaderModule fragmentShader;
+	std::uint32_t constants[3]; // antiAliasing, pushConstants, textureCount
+	vk::SampleCountBits samples;
+	bool indexed;
+	unsigned int packedVertices;
 };
 
 // The RenderBuilder implementation used to render on a swapchain.
@@ -106,159 +322,268 @@ template<> struct VulkanType<vvg::UniformData> {
 
 namespace vvg {
 
-//Renderer
-Renderer::Renderer(const vpp::Swapchain& swapchain, const vpp::Queue* presentQueue)
-	: vpp::Resource(swapchain.device()), swapchain_(&swapchain), presentQueue_(presentQueue)
+// Converts the given float to a half float, values out of range are clamped to infinity
+// and denormals are flushed to zero. Only used for colors.
+std::uint32_t toHalf(float value)
 {
-	initRenderPass(swapchain.device(), swapchain.format());
-	init();
+	std::uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
 
-	auto impl = std::make_unique<RenderImpl>();
-	impl->renderer = this;
-	impl->swapchainRenderer = &renderer_;
+	auto sign = (bits >> 16) & 0x8000u;
+	auto exponent = int((bits >> 23) & 0xFFu) - 127 + 15;
+	auto mantissa = bits & 0x7FFFFFu;
 
-	auto attachmentInfo = vpp::ViewableImage::defaultDepth2D();
-	attachmentInfo.imgInfo.format = vk::Format::s8Uint;
-	attachmentInfo.viewInfo.format = vk::Format::s8Uint;
-	attachmentInfo.viewInfo.subresourceRange.aspectMask = vk::ImageAspectBits::stencil;
+	if(exponent <= 0) return sign;
+	if(exponent >= 31) return sign | 0x7C00u;
 
-	vpp::SwapchainRenderer::CreateInfo info {renderPass_, 0, {{attachmentInfo}}};
-	renderer_ = {swapchain, info, std::move(impl)};
+	// round to nearest, a carry correctly increases the exponent
+	auto half = sign | (std::uint32_t(exponent) << 10) | (mantissa >> 13);
+	if(mantissa & 0x1000u) ++half;
+	return half;
 }
 
-Renderer::Renderer(const vpp::Framebuffer& framebuffer, vk::RenderPass rp)
-	: vpp::Resource(framebuffer.device()), framebuffer_(&framebuffer), renderPassHandle_(rp)
+// Packs two floats into one uint like glsl packHalf2x16.
+std::uint32_t packHalf2x16(float x, float y)
 {
-	init();
-	commandBuffer_ = framebuffer.device().commandProvider().get(renderQueue_->family());
+	return toHalf(x) | (toHalf(y) << 16);
 }
 
+// Creates the compact push constant data for the given uniform data.
+PushData pushData(const UniformData& data)
+{
+	auto& sm = data.scissorMat;
+	auto& pm = data.paintMat;
+	auto typeBits = data.type | (data.texType << 8);
+
+	PushData ret;
+	ret.scissorMat = {sm[0][0], sm[0][1], sm[1][0], sm[1][1]};
+	ret.scissorTranslateExtent = {sm[2][0], sm[2][1], sm[3][0], sm[3][1]};
+	ret.scissorScaleViewSize = {sm[3][2], sm[3][3], data.viewSize.x, data.viewSize.y};
+	ret.paintMat = {pm[0][0], pm[0][1], pm[1][0], pm[1][1]};
+	ret.paintTranslateExtent = {pm[2][0], pm[2][1], pm[3][0], pm[3][1]};
+	ret.params[0] = sm[0][3];
+	ret.params[1] = sm[1][3];
+	ret.params[2] = pm[0][3];
+	ret.typeBits = typeBits;
+
+	auto& ic = data.innerColor;
+	auto& oc = data.outerColor;
+	ret.colors[0] = packHalf2x16(ic.x, ic.y);
+	ret.colors[1] = packHalf2x16(ic.z, ic.w);
+	ret.colors[2] = packHalf2x16(oc.x, oc.y);
+	ret.colors[3] = packHalf2x16(oc.z, oc.w);
+
+	ret.transform = {pm[3][2], pm[3][3], pm[1][3], pm[2][3]};
+	return ret;
+}
 
-Renderer::~Renderer()
+// Returns the uniform data of a draw of the given operation with the parameters of the
+// operation applied.
+UniformData operationUniformData(const RenderOperation& operation, const DrawData& draw,
+	Vec2 viewSize)
 {
+	auto data = draw.uniformData;
+	data.viewSize = viewSize;
+
+	auto& position = operation.position.get();
+	auto& scale = operation.scale.get();
+	data.paintMat[3][2] = position[0];
+	data.paintMat[3][3] = position[1];
+	data.paintMat[1][3] = scale[0];
+	data.paintMat[2][3] = scale[1];
+
+	auto& color = operation.color.get();
+	for(auto* c : {&data.innerColor, &data.outerColor}) {
+		c->x *= color[0];
+		c->y *= color[1];
+		c->z *= color[2];
+		c->w *= color[3];
+	}
 
+	return data;
 }
 
-void Renderer::init()
-{
-	// queues
-	renderQueue_ = device().queue(vk::QueueBits::graphics);
+// 64 bit hash of a stream of 8 byte words.
+// Every word is combined using the murmur3 finalizer, so a difference in any bit changes
+// the whole value and differences in multiple words do not cancel out.
+struct Hasher {
+	std::uint64_t value = 14695981039346656037ull;
 
-	if(swapchain_ && !presentQueue_) {
-		auto surface = swapchain_->vkSurface();
-		auto supported = vpp::supportedQueueFamilies(vkInstance(), surface, vkPhysicalDevice());
-		for(auto q : supported)
-			if((presentQueue_ = device().queue(q)))
-				break;
+	static std::uint64_t mix(std::uint64_t x)
+	{
+		x ^= x >> 33;
+		x *= 0xff51afd7ed558ccdull;
+		x ^= x >> 33;
+		x *= 0xc4ceb9fe1a85ec53ull;
+		x ^= x >> 33;
+		return x;
+	}
 
-		if(!presentQueue_)
-			throw std::runtime_error("vvg::Renderer::init: cannot find present queue");
+	void add(const void* data, std::size_t size)
+	{
+		auto bytes = static_cast<const std::uint8_t*>(data);
+		auto i = std::size_t(0);
+		for(; i + 8 <= size; i += 8) {
+			std::uint64_t word;
+			std::memcpy(&word, bytes + i, 8);
+			value = mix(value ^ word) + 0x9e3779b97f4a7c15ull;
+		}
+
+		// the remaining bytes are combined as one word together with their count
+		if(i < size) {
+			std::uint64_t word = 0;
+			std::memcpy(&word, bytes + i, size - i);
+			word |= std::uint64_t(size - i) << 56;
+			value = mix(value ^ word) + 0x9e3779b97f4a7c15ull;
+		}
 	}
 
-	// sampler
-	vk::SamplerCreateInfo samplerInfo;
-	samplerInfo.magFilter = vk::Filter::linear;
-	samplerInfo.minFilter = vk::Filter::linear;
-	samplerInfo.mipmapMode = vk::SamplerMipmapMode::linear;
-	samplerInfo.addressModeU = vk::SamplerAddressMode::clampToEdge;
-	samplerInfo.addressModeV = vk::SamplerAddressMode::clampToEdge;
-	samplerInfo.addressModeW = vk::SamplerAddressMode::clampToEdge;
-	samplerInfo.mipLodBias = 0;
-	samplerInfo.anisotropyEnable = true;
-	samplerInfo.maxAnisotropy = 1;
-	samplerInfo.compareEnable = false;
-	samplerInfo.compareOp = {};
-	samplerInfo.minLod = 0;
-	samplerInfo.maxLod = 0;
-	samplerInfo.borderColor = vk::BorderColor::floatTransparentBlack;
-	samplerInfo.unnormalizedCoordinates = false;
-	sampler_ = {device(), samplerInfo};
+	template<typename T> void add(const T& obj) { add(&obj, sizeof(obj)); }
+};
 
-	// descLayout
-	auto descriptorBindings  = {
-		vpp::descriptorBinding(vk::DescriptorType::uniformBuffer,
-			vk::ShaderStageBits::vertex | vk::ShaderStageBits::fragment),
-		vpp::descriptorBinding(vk::DescriptorType::combinedImageSampler,
-			vk::ShaderStageBits::fragment, -1, 1, &sampler_.vkHandle())
-	};
+// Adds the versions of the dynamic parameters of the given operation.
+void addParameters(Hasher& hash, const RenderOperation& operation)
+{
+	hash.add(operation.position.version());
+	hash.add(operation.scale.version());
+	hash.add(operation.color.version());
+}
+
+// Returns the stride of the per-draw uniform data in uniform buffers.
+std::size_t uniformStride(const vpp::Device& dev)
+{
+	auto align = dev.properties().limits.minUniformBufferOffsetAlignment;
+	return ((sizeof(UniformData) + align - 1) / align) * align;
+}
+
+// Returns the size of one pixel of the given texture format in bytes.
+unsigned int formatSize(vk::Format format)
+{
+	return (format == vk::Format::r8Unorm) ? 1 : 4;
+}
+
+// Returns the layout the given texture has while data is copied into it.
+vk::ImageLayout transferLayout(const Texture& texture)
+{
+	return (texture.layout() == vk::ImageLayout::general) ?
+		vk::ImageLayout::general : vk::ImageLayout::transferDstOptimal;
+}
+
+// Sets the dynamic viewport and scissor state to the whole render target.
+void recordViewport(vk::CommandBuffer cmdBuffer, unsigned int width, unsigned int height)
+{
+	vk::Viewport viewport;
+	viewport.width = width;
+	viewport.height = height;
+	viewport.minDepth = 0.f;
+	viewport.maxDepth = 1.f;
+	vk::cmdSetViewport(cmdBuffer, 0, 1, viewport);
+
+	vk::Rect2D scissor;
+	scissor.extent = {width, height};
+	scissor.offset = {0, 0};
+	vk::cmdSetScissor(cmdBuffer, 0, 1, scissor);
+}
+
+// Adds the commands counted while recording to the stats of the frame.
+void addRecordStats(FrameStats& stats, const RecordState& state)
+{
+	stats.pipelineBinds += state.pipelineBinds;
+	stats.descriptorBinds += state.descriptorBinds;
+	stats.drawCommands += state.drawCommands;
+}
+
+// Returns the milliseconds that passed since the given time point.
+double millisecondsSince(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Writes the given data into the memory of the given (mappable) buffer.
+void writeBuffer(const vpp::Buffer& buffer, std::size_t offset, const void* data,
+	std::size_t size)
+{
+	auto map = buffer.memoryMap();
+	std::memcpy(map.ptr() + offset, data, size);
+	if(!map.coherent()) map.flush();
+}
 
-	descriptorLayout_ = {device(), descriptorBindings};
-	pipelineLayout_ = {device(), {descriptorLayout_}, {}};
-
-	//create the graphics pipeline
-	// vpp::GraphicsPipelineBuilder builder(device(), vkRenderPass());
-	// builder.dynamicStates = {vk::DynamicState::viewport, vk::DynamicState::scissor};
-	// builder.states.rasterization.cullMode = vk::CullModeBits::none;
-	// builder.states.inputAssembly.topology = vk::PrimitiveTopology::triangleFan;
-	// builder.states.blendAttachments[0].blendEnable = true;
-	// builder.states.blendAttachments[0].colorBlendOp = vk::BlendOp::add;
-	// builder.states.blendAttachments[0].srcColorBlendFactor = vk::BlendFactor::srcAlpha;
-	// builder.states.blendAttachments[0].dstColorBlendFactor = vk::BlendFactor::oneMinusSrcAlpha;
-	// builder.states.blendAttachments[0].srcAlphaBlendFactor = vk::BlendFactor::one;
-	// builder.states.blendAttachments[0].dstAlphaBlendFactor = vk::BlendFactor::zero;
-	// builder.states.blendAttachments[0].alphaBlendOp = vk::BlendOp::add;
-	//
-	// vpp::VertexBufferLayout vertexLayout {{vk::Format::r32g32Sfloat, vk::Format::r32g32Sfloat}};
-	// builder.vertexBufferLayouts = {vertexLayout};
-	// builder.layout = pipelineLayout_;
-	//
-	// //shader
-	// //the fragment shader has a constant for antialiasing
-	// std::uint32_t antiAliasing = edgeAA_;
-	// vk::SpecializationMapEntry entry {0, 0, 4};
-	//
-	// vk::SpecializationInfo specInfo;
-	// specInfo.mapEntryCount = 1;
-	// specInfo.pMapEntries = &entry;
-	// specInfo.dataSize = 4;
-	// specInfo.pData = &antiAliasing;
-	//
-	// builder.shader.stage(fill_vert_data, {vk::ShaderStageBits::vertex});
-	// builder.shader.stage(fill_frag_data, {vk::ShaderStageBits::fragment, &specInfo});
-	//
-	// fanPipeline_ = builder.build();
-	//
-	// builder.states.inputAssembly.topology = vk::PrimitiveTopology::triangleStrip;
-	// stripPipeline_ = builder.build();
-	//
-	// builder.states.inputAssembly.topology = vk::PrimitiveTopology::triangleList;
-	// listPipeline_ = builder.build();
-
-
-	std::uint32_t antiAliasing = edgeAA_;
-	vk::SpecializationMapEntry entry {0, 0, 4};
+// Returns the key of the pipeline with the given type and paint variant.
+// With blendAlpha the destination alpha is blended instead of replaced by the draw's alpha.
+// Only strokes and fill fringes need the stroke mask for antialiasing, the fill interiors
+// and the cover quad have constant texture coordinates and textures never use it.
+// The stencil pass writes no color, all stencil fills share the cheapest variant. It must
+// still discard outside of the scissor like the cover pass that resets the stencil.
+std::uint32_t pipelineKey(PipelineType type, std::uint32_t variant, bool edgeAA,
+	bool blendAlpha)
+{
+	if(type == pipelineFillStencil)
+		return type | ((typeColor | (variant & variantScissor)) << pipelineTypeBits);
+
+	if(blendAlpha)
+		variant |= variantBlendAlpha;
+
+	auto stroke = (type == pipelineStrip || type == pipelineList || type == pipelineFillFringe);
+	if(edgeAA && stroke && (variant & 3u) != typeTexture)
+		variant |= variantStrokeAA;
+
+	return type | (variant << pipelineTypeBits);
+}
+
+// Creates the pipeline with the given key. Called from background threads, the
+// pipeline cache is internally synchronized.
+vk::Pipeline createPipeline(const PipelineContext& ctx, std::uint32_t key)
+{
+	auto type = static_cast<PipelineType>(key & pipelineTypeMask);
+	auto variant = key >> pipelineTypeBits;
+
+	// constant 0: antiAliasing, constant 1: pushConstants, constant 2: textureCount
+	// constants 3 to 6: paintType, textureFormat, scissored, strokeAntiAlias
+	// constant 7: positionScale (float), only used by the vertex shader
+	auto packed = ctx.packedVertices;
+	auto positionScale = packed ? 32767.f / packed : 1.f;
+	std::uint32_t constants[] = {ctx.constants[0], ctx.constants[1], ctx.constants[2],
+		variant & 3u, (variant >> 2) & 3u, (variant & variantScissor) != 0,
+		(variant & variantStrokeAA) != 0, 0};
+	std::memcpy(&constants[7], &positionScale, 4);
+	vk::SpecializationMapEntry entries[] = {{0, 0, 4}, {1, 4, 4}, {2, 8, 4}, {3, 12, 4},
+		{4, 16, 4}, {5, 20, 4}, {6, 24, 4}, {7, 28, 4}};
 
 	vk::SpecializationInfo specInfo;
-	specInfo.mapEntryCount = 1;
-	specInfo.pMapEntries = &entry;
-	specInfo.dataSize = 4;
-	specInfo.pData = &antiAliasing;
+	specInfo.mapEntryCount = 8;
+	specInfo.pMapEntries = entries;
+	specInfo.dataSize = sizeof(constants);
+	specInfo.pData = constants;
 
-	vpp::ShaderModule vertexShader(device(), fill_vert_data);
-	vpp::ShaderModule fragmentShader(device(), fill_frag_data);
+	vk::PipelineShaderStageCreateInfo stages[2] {};
+	stages[0].stage = vk::ShaderStageBits::vertex;
+	stages[0].module = ctx.vertexShader;
+	stages[0].pName = "main";
+	stages[0].pSpecializationInfo = &specInfo;
 
-	vpp::ShaderProgram shaderStages({
-		{vertexShader, vk::ShaderStageBits::vertex},
-		{fragmentShader, vk::ShaderStageBits::fragment, &specInfo}
-	});
+	stages[1] = stages[0];
+	stages[1].stage = vk::ShaderStageBits::fragment;
+	stages[1].module = ctx.fragmentShader;
 
 	vk::GraphicsPipelineCreateInfo pipelineInfo;
-	pipelineInfo.renderPass = vkRenderPass();
-	pipelineInfo.layout = pipelineLayout_;
+	pipelineInfo.renderPass = ctx.renderPass;
+	pipelineInfo.layout = ctx.layout;
 
-	pipelineInfo.stageCount = shaderStages.vkStageInfos().size();
-	pipelineInfo.pStages = shaderStages.vkStageInfos().data();
+	pipelineInfo.stageCount = 2;
+	pipelineInfo.pStages = stages;
 
-	constexpr auto stride = (2 * 4) * 2; // 2 pos floats, 2 uv floats
+	// 2 pos floats, 2 uv floats or the PackedVertex
+	std::uint32_t stride = packed ? sizeof(PackedVertex) : (2 * 4) * 2;
 	vk::VertexInputBindingDescription bufferBinding {0, stride, vk::VertexInputRate::vertex};
 
 	// vertex position, uv attributes
+	// snorm and unorm 16 bit vertex formats must be supported by all devices
 	vk::VertexInputAttributeDescription attributes[2];
-	attributes[0].format = vk::Format::r32g32Sfloat;
+	attributes[0].format = packed ? vk::Format::r16g16Snorm : vk::Format::r32g32Sfloat;
 
 	attributes[1].location = 1;
-	attributes[1].format = vk::Format::r32g32Sfloat;
-	attributes[1].offset = 2 * 4; // offset pos (vec2f)
+	attributes[1].format = packed ? vk::Format::r16g16Unorm : vk::Format::r32g32Sfloat;
+	attributes[1].offset = stride / 2; // offset pos
 
 	vk::PipelineVertexInputStateCreateInfo vertexInfo;
 	vertexInfo.vertexBindingDescriptionCount = 1;
@@ -282,7 +607,7 @@ void Renderer::init()
 	pipelineInfo.pRasterizationState = &rasterizationInfo;
 
 	vk::PipelineMultisampleStateCreateInfo multisampleInfo;
-	multisampleInfo.rasterizationSamples = vk::SampleCountBits::e1;
+	multisampleInfo.rasterizationSamples = ctx.samples;
 	pipelineInfo.pMultisampleState = &multisampleInfo;
 
 	vk::PipelineColorBlendAttachmentState blendAttachment;
@@ -292,7 +617,8 @@ void Renderer::init()
 	blendAttachment.srcColorBlendFactor = vk::BlendFactor::srcAlpha;
 	blendAttachment.dstColorBlendFactor = vk::BlendFactor::oneMinusSrcAlpha;
 	blendAttachment.srcAlphaBlendFactor = vk::BlendFactor::one;
-	blendAttachment.dstAlphaBlendFactor = vk::BlendFactor::zero;
+	blendAttachment.dstAlphaBlendFactor = (variant & variantBlendAlpha) ?
+		vk::BlendFactor::oneMinusSrcAlpha : vk::BlendFactor::zero;
 	blendAttachment.colorWriteMask =
 		vk::ColorComponentBits::r |
 		vk::ColorComponentBits::g |
@@ -319,265 +645,1821 @@ void Renderer::init()
 	dynamicInfo.pDynamicStates = dynStates.begin();
 	pipelineInfo.pDynamicState = &dynamicInfo;
 
-	// copy for strip pipeline
-	auto stripInfo = pipelineInfo;
-	auto stripAssembly = assemblyInfo;
-	stripAssembly.topology = vk::PrimitiveTopology::triangleStrip;
-	stripInfo.pInputAssemblyState = &stripAssembly;
-	stripInfo.basePipelineIndex = 0;
+	// stencil fill pipelines, used for all fills that are not a single convex path
+	// the fans are only drawn into the stencil buffer (non-zero winding rule), then the
+	// antialiased fringes are drawn where the stencil is not set and finally the bounds
+	// are covered where it is set. The cover pass also resets the stencil to 0.
+	// with indexed geometry everything is drawn as triangle lists
+	auto fanTopology = ctx.indexed ?
+		vk::PrimitiveTopology::triangleList : vk::PrimitiveTopology::triangleFan;
+	auto stripTopology = ctx.indexed ?
+		vk::PrimitiveTopology::triangleList : vk::PrimitiveTopology::triangleStrip;
+
+	vk::StencilOpState stencilOp;
+	stencilOp.failOp = vk::StencilOp::keep;
+	stencilOp.passOp = vk::StencilOp::keep;
+	stencilOp.depthFailOp = vk::StencilOp::keep;
+	stencilOp.compareMask = 0xFF;
+	stencilOp.writeMask = 0xFF;
+	stencilOp.reference = 0;
+
+	switch(type) {
+		case pipelineFan:
+			assemblyInfo.topology = vk::PrimitiveTopology::triangleFan;
+			break;
+		case pipelineStrip:
+			assemblyInfo.topology = vk::PrimitiveTopology::triangleStrip;
+			break;
+		case pipelineList:
+			break;
+		case pipelineFillStencil:
+			assemblyInfo.topology = fanTopology;
+			blendAttachment.colorWriteMask = {};
+			depthStencilInfo.stencilTestEnable = true;
+			depthStencilInfo.front = stencilOp;
+			depthStencilInfo.front.compareOp = vk::CompareOp::always;
+			depthStencilInfo.front.passOp = vk::StencilOp::incrementAndWrap;
+			depthStencilInfo.back = depthStencilInfo.front;
+			depthStencilInfo.back.passOp = vk::StencilOp::decrementAndWrap;
+			break;
+		case pipelineFillFringe:
+			assemblyInfo.topology = stripTopology;
+			depthStencilInfo.stencilTestEnable = true;
+			depthStencilInfo.front = stencilOp;
+			depthStencilInfo.front.compareOp = vk::CompareOp::equal;
+			depthStencilInfo.back = depthStencilInfo.front;
+			break;
+		case pipelineFillCover:
+			assemblyInfo.topology = stripTopology;
+			depthStencilInfo.stencilTestEnable = true;
+			depthStencilInfo.front = stencilOp;
+			depthStencilInfo.front.compareOp = vk::CompareOp::notEqual;
+			depthStencilInfo.front.failOp = vk::StencilOp::zero;
+			depthStencilInfo.front.passOp = vk::StencilOp::zero;
+			depthStencilInfo.back = depthStencilInfo.front;
+			break;
+	}
 
-	// copy for fan pipelien
-	auto fanInfo = pipelineInfo;
-	auto fanAssembly = assemblyInfo;
-	fanAssembly.topology = vk::PrimitiveTopology::triangleFan;
-	fanInfo.pInputAssemblyState = &fanAssembly;
-	fanInfo.basePipelineIndex = 0;
+	return vk::createGraphicsPipelines(ctx.device, ctx.cache, {pipelineInfo})[0];
+}
 
-	constexpr auto cacheName = "grapihcsPipelineCache.bin";
+// Creates a render pass with the color target as attachment 0 and the stencil as
+// attachment 1. With multisampling the multisampled color attachment 2 is resolved
+// into the target.
+vpp::RenderPass createRenderPass(const vpp::Device& dev, vk::Format format,
+	vk::SampleCountBits samples, vk::ImageLayout finalLayout)
+{
+	vk::AttachmentDescription attachments[3] {};
+	auto multisampled = (samples != vk::SampleCountBits::e1);
 
-	vpp::PipelineCache cache;
-	if(vpp::fileExists(cacheName)) cache = {device(), cacheName};
-	else cache = {device()};
-	auto pipelines = vk::createGraphicsPipelines(device(), cache,
-		{pipelineInfo, stripInfo, fanInfo});
+	//color target, from the swapchain or an offscreen image
+	attachments[0].format = format;
+	attachments[0].samples = vk::SampleCountBits::e1;
+	attachments[0].loadOp = vk::AttachmentLoadOp::clear;
+	attachments[0].storeOp = vk::AttachmentStoreOp::store;
+	attachments[0].stencilLoadOp = vk::AttachmentLoadOp::dontCare;
+	attachments[0].stencilStoreOp = vk::AttachmentStoreOp::dontCare;
+	attachments[0].initialLayout = vk::ImageLayout::undefined;
+	attachments[0].finalLayout = finalLayout;
 
-	listPipeline_ = {device(), pipelines[0]};
-	stripPipeline_ = {device(), pipelines[1]};
-	fanPipeline_ = {device(), pipelines[2]};
+	vk::AttachmentReference colorReference;
+	colorReference.attachment = 0;
+	colorReference.layout = vk::ImageLayout::colorAttachmentOptimal;
 
-	// save the cache to the file we tried to load it from
-	vpp::save(cache, cacheName);
+	//multisampled color, resolved into the target
+	//the target does not have to be cleared then
+	vk::AttachmentReference resolveReference = colorReference;
+	if(multisampled) {
+		attachments[0].loadOp = vk::AttachmentLoadOp::dontCare;
+
+		attachments[2] = attachments[0];
+		attachments[2].samples = samples;
+		attachments[2].loadOp = vk::AttachmentLoadOp::clear;
+		attachments[2].storeOp = vk::AttachmentStoreOp::dontCare;
+		attachments[2].finalLayout = vk::ImageLayout::colorAttachmentOptimal;
+		colorReference.attachment = 2;
+	}
 
-	// create a dummy image used for unbound image descriptors
-	// TODO: find out if this is actually needed or a bug in the layers
-	dummyTexture_ = {device(), (unsigned int) -1, {2, 2}, vk::Format::r8g8b8a8Unorm};
-}
+	//stencil attachment
+	//will not be used as depth buffer
+	attachments[1].format = vk::Format::s8Uint;
+	attachments[1].samples = samples;
+	attachments[1].loadOp = vk::AttachmentLoadOp::dontCare;
+	attachments[1].storeOp = vk::AttachmentStoreOp::dontCare;
+	attachments[1].stencilLoadOp = vk::AttachmentLoadOp::clear;
+	attachments[1].stencilStoreOp = vk::AttachmentStoreOp::dontCare;
+	attachments[1].initialLayout = vk::ImageLayout::undefined;
+	attachments[1].finalLayout = vk::ImageLayout::depthStencilAttachmentOptimal;
+	// attachments[1].initialLayout = vk::ImageLayout::depthStencilAttachmentOptimal;
+	// attachments[1].finalLayout = vk::ImageLayout::depthStencilAttachmentOptimal;
 
-unsigned int Renderer::createTexture(vk::Format format, unsigned int w, unsigned int h,
-	const std::uint8_t* data)
-{
-	++texID_;
-	textures_.emplace_back(device(), texID_, vk::Extent2D{w, h}, format, data);
-	return texID_;
-}
+	vk::AttachmentReference depthReference;
+	depthReference.attachment = 1;
+	depthReference.layout = vk::ImageLayout::depthStencilAttachmentOptimal;
 
-bool Renderer::deleteTexture(unsigned int id)
-{
-	auto it = std::find_if(textures_.begin(), textures_.end(),
-		[=](const auto& tex) { return tex.id() == id; });
+	//only subpass
+	vk::SubpassDescription subpass;
+	subpass.pipelineBindPoint = vk::PipelineBindPoint::graphics;
+	subpass.flags = {};
+	subpass.inputAttachmentCount = 0;
+	subpass.pInputAttachments = nullptr;
+	subpass.colorAttachmentCount = 1;
+	subpass.pColorAttachments = &colorReference;
+	subpass.pResolveAttachments = multisampled ? &resolveReference : nullptr;
+	subpass.pDepthStencilAttachment = &depthReference;
+	subpass.preserveAttachmentCount = 0;
+	subpass.pPreserveAttachments = nullptr;
 
-	if(it == textures_.end()) return false;
+	//the attachments are reused by every frame, so the clear and the layout transitions
+	//have to wait for the reads and writes of the previous frame (as attachment, copy source
+	//or texture). The final layout transition is made visible to the following users
+	vk::SubpassDependency dependencies[2] {};
+	dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+	dependencies[0].dstSubpass = 0;
+	dependencies[0].srcStageMask = vk::PipelineStageBits::colorAttachmentOutput |
+		vk::PipelineStageBits::lateFragmentTests | vk::PipelineStageBits::fragmentShader |
+		vk::PipelineStageBits::transfer;
+	dependencies[0].srcAccessMask = vk::AccessBits::colorAttachmentWrite |
+		vk::AccessBits::depthStencilAttachmentWrite;
+	dependencies[0].dstStageMask = vk::PipelineStageBits::colorAttachmentOutput |
+		vk::PipelineStageBits::earlyFragmentTests;
+	dependencies[0].dstAccessMask = vk::AccessBits::colorAttachmentRead |
+		vk::AccessBits::colorAttachmentWrite | vk::AccessBits::depthStencilAttachmentRead |
+		vk::AccessBits::depthStencilAttachmentWrite;
+
+	dependencies[1].srcSubpass = 0;
+	dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+	dependencies[1].srcStageMask = vk::PipelineStageBits::colorAttachmentOutput;
+	dependencies[1].srcAccessMask = vk::AccessBits::colorAttachmentWrite;
+	if(finalLayout == vk::ImageLayout::shaderReadOnlyOptimal) {
+		dependencies[1].dstStageMask = vk::PipelineStageBits::fragmentShader;
+		dependencies[1].dstAccessMask = vk::AccessBits::shaderRead;
+	} else if(finalLayout == vk::ImageLayout::transferSrcOptimal) {
+		dependencies[1].dstStageMask = vk::PipelineStageBits::transfer;
+		dependencies[1].dstAccessMask = vk::AccessBits::transferRead;
+	} else {
+		//presenting waits for the semaphore signaled by the submission
+		dependencies[1].dstStageMask = vk::PipelineStageBits::bottomOfPipe;
+		dependencies[1].dstAccessMask = {};
+	}
 
-	textures_.erase(it);
-	return true;
+	vk::RenderPassCreateInfo renderPassInfo;
+	renderPassInfo.attachmentCount = multisampled ? 3 : 2;
+	renderPassInfo.pAttachments = attachments;
+	renderPassInfo.subpassCount = 1;
+	renderPassInfo.pSubpasses = &subpass;
+	renderPassInfo.dependencyCount = 2;
+	renderPassInfo.pDependencies = dependencies;
+
+	return {dev, renderPassInfo};
 }
 
-void Renderer::start(unsigned int width, unsigned int height)
+//SharedResources
+SharedResources::SharedResources(const vpp::Device& dev, const RendererSettings& settings)
+	: vpp::Resource(dev), settings_(settings)
 {
-	// store (and set) viewport in some way
-	width_ = width;
-	height_ = height;
+	settings_.sharedResources = {};
 
-	vertices_.clear();
-	drawDatas_.clear();
+	// multisampling replaces the fringe antialiasing
+	auto& limits = device().properties().limits;
+	auto samples = settings_.sampleCount;
+	if(!(limits.framebufferColorSampleCounts & limits.framebufferStencilSampleCounts & samples))
+		throw std::runtime_error("vvg::SharedResources: sampleCount not supported");
+
+	edgeAA_ = (samples == vk::SampleCountBits::e1);
+
+	// sampler
+	vk::SamplerCreateInfo samplerInfo;
+	samplerInfo.magFilter = vk::Filter::linear;
+	samplerInfo.minFilter = vk::Filter::linear;
+	samplerInfo.mipmapMode = vk::SamplerMipmapMode::linear;
+	samplerInfo.addressModeU = vk::SamplerAddressMode::clampToEdge;
+	samplerInfo.addressModeV = vk::SamplerAddressMode::clampToEdge;
+	samplerInfo.addressModeW = vk::SamplerAddressMode::clampToEdge;
+	samplerInfo.mipLodBias = 0;
+	samplerInfo.anisotropyEnable = true;
+	samplerInfo.maxAnisotropy = 1;
+	samplerInfo.compareEnable = false;
+	samplerInfo.compareOp = {};
+	samplerInfo.minLod = 0;
+	samplerInfo.maxLod = 0;
+	samplerInfo.borderColor = vk::BorderColor::floatTransparentBlack;
+	samplerInfo.unnormalizedCoordinates = false;
+	sampler_ = {device(), samplerInfo};
+
+	// descLayouts
+	// the uniform data of all draw calls is selected using a dynamic offset, descriptor sets
+	// are only needed once per frame (uniform buffer) and once per texture (or once per
+	// frame when using a texture array).
+	auto arraySize = settings_.textureArraySize;
+	if(arraySize > limits.maxPerStageDescriptorSampledImages)
+		throw std::runtime_error("vvg::SharedResources: textureArraySize exceeds device limits");
+
+	auto textureCount = std::max(arraySize, 1u);
+	std::vector<vk::Sampler> samplers(textureCount, sampler_.vkHandle());
+
+	auto uniformBindings = {
+		vpp::descriptorBinding(vk::DescriptorType::uniformBufferDynamic,
+			vk::ShaderStageBits::vertex | vk::ShaderStageBits::fragment),
+	};
+
+	auto textureBindings = {
+		vpp::descriptorBinding(vk::DescriptorType::combinedImageSampler,
+			vk::ShaderStageBits::fragment, -1, textureCount, samplers.data())
+	};
+
+	// the push constant range is only used in the push constant mode but the layout
+	// is shared by all pipelines
+	vk::PushConstantRange pushRange;
+	pushRange.stageFlags = vk::ShaderStageBits::vertex | vk::ShaderStageBits::fragment;
+	pushRange.offset = 0;
+	pushRange.size = sizeof(PushData);
+
+	uniformLayout_ = {device(), uniformBindings};
+	textureLayout_ = {device(), textureBindings};
+	pipelineLayout_ = {device(), {uniformLayout_, textureLayout_}, {pushRange}};
+
+	// the shader modules are kept alive since pipelines are created on first use
+	vertexShader_ = {device(), fill_vert_data};
+	fragmentShader_ = {device(), fill_frag_data};
+	initPipelineCache();
+
+	// create a dummy image used for unbound image descriptors
+	// its layout is initialized with the first frame instead of blocking here
+	// TODO: find out if this is actually needed or a bug in the layers
+	dummyTexture_ = {device(), (unsigned int) -1, {2, 2}, vk::Format::r8g8b8a8Unorm,
+		nullptr, false};
+	dummyPending_ = true;
+	if(!arraySize)
+		dummyTextureSet_ = createTextureSet(dummyTexture_);
 }
 
-void Renderer::cancel()
+SharedResources::~SharedResources()
 {
+	savePipelineCache();
 }
 
-void Renderer::flush()
+void SharedResources::initPipelineCache()
 {
-	if(drawDatas_.empty())
+	if(settings_.pipelineCacheDirectory.empty()) {
+		pipelineCache_ = {device()};
 		return;
-
-	// allocate buffers
-	auto uniformSize = sizeof(UniformData) * drawDatas_.size();
-	auto bits = device().memoryTypeBits(vk::MemoryPropertyBits::hostVisible);
-
-	if(uniformBuffer_.memorySize() < uniformSize) {
-		vk::BufferCreateInfo bufInfo;
-		bufInfo.usage = vk::BufferUsageBits::uniformBuffer;
-		bufInfo.size = uniformSize;
-		uniformBuffer_ = {device(), bufInfo, bits};
 	}
 
-	auto vertexSize = vertices_.size() * sizeof(NVGvertex);
-	if(vertexBuffer_.memorySize() < vertexSize) {
-		vk::BufferCreateInfo bufInfo;
-		bufInfo.usage = vk::BufferUsageBits::vertexBuffer;
-		bufInfo.size = vertexSize;
-		vertexBuffer_ = {device(), bufInfo, bits};
+	// caches are only valid for the device and driver they were created with
+	auto& props = device().properties();
+	std::string uuid;
+	for(auto byte : props.pipelineCacheUUID) {
+		char hex[3];
+		std::snprintf(hex, sizeof(hex), "%02x", byte);
+		uuid += hex;
 	}
 
-	// descriptorPool
-	if(drawDatas_.size() > descriptorPoolSize_) {
-		vk::DescriptorPoolSize typeCounts[2];
-		typeCounts[0].type = vk::DescriptorType::uniformBuffer;
-		typeCounts[0].descriptorCount = drawDatas_.size();
+	pipelineCachePath_ = settings_.pipelineCacheDirectory + "/vvg-" + uuid + "-" +
+		std::to_string(props.driverVersion) + ".cache";
 
-		typeCounts[1].type = vk::DescriptorType::combinedImageSampler;
-		typeCounts[1].descriptorCount = drawDatas_.size();
+	if(vpp::fileExists(pipelineCachePath_)) pipelineCache_ = {device(), pipelineCachePath_};
+	else pipelineCache_ = {device()};
+}
 
-		vk::DescriptorPoolCreateInfo poolInfo;
-		poolInfo.poolSizeCount = 2;
-		poolInfo.pPoolSizes = typeCounts;
-		poolInfo.maxSets = drawDatas_.size();
+void SharedResources::savePipelineCache()
+{
+	// background creation uses the cache and the shader modules
+	resolvePipelines();
+	if(!pipelineCachePath_.empty())
+		vpp::save(pipelineCache_, pipelineCachePath_);
+}
 
-		descriptorPool_ = {device(), poolInfo};
-		descriptorPoolSize_ = drawDatas_.size();
-	} else if(descriptorPool_) {
-		vk::resetDescriptorPool(device(), descriptorPool_, {});
+void SharedResources::preparePipeline(vk::RenderPass renderPass, std::uint32_t key)
+{
+	auto it = std::find_if(pipelines_.begin(), pipelines_.end(),
+		[&](const auto& entry) { return entry.first == renderPass; });
+	if(it == pipelines_.end()) {
+		pipelines_.emplace_back();
+		pipelines_.back().first = renderPass;
+		it = pipelines_.end() - 1;
 	}
 
-	// update
-	vpp::BufferUpdate update(uniformBuffer_, vpp::BufferLayout::std140);
-	for(auto& data : drawDatas_) {
-		update.alignUniform();
-
-		auto offset = update.offset();
-		update.add(vpp::raw(data.uniformData, 1)); // TODO
+	auto& entry = it->second[key];
+	if(entry.pipeline || entry.pending.valid())
+		return;
 
-		data.descriptorSet = {descriptorLayout_, descriptorPool_};
+	auto textureCount = std::max(settings_.textureArraySize, 1u);
+
+	PipelineContext ctx;
+	ctx.device = device();
+	ctx.cache = pipelineCache_;
+	ctx.layout = pipelineLayout_;
+	ctx.renderPass = renderPass;
+	ctx.vertexShader = vertexShader_;
+	ctx.fragmentShader = fragmentShader_;
+	ctx.constants[0] = edgeAA_;
+	ctx.constants[1] = settings_.pushConstants;
+	ctx.constants[2] = textureCount;
+	ctx.samples = settings_.sampleCount;
+	ctx.indexed = settings_.indexedGeometry;
+	ctx.packedVertices = settings_.packedVertices;
+
+	entry.pending = std::async(std::launch::async, [ctx, key]{
+		return createPipeline(ctx, key);
+	});
+}
 
-		vpp::DescriptorSetUpdate descUpdate(data.descriptorSet);
-		descUpdate.uniform({{uniformBuffer_, offset, sizeof(UniformData)}});
+void SharedResources::resolvePipelines()
+{
+	for(auto& pass : pipelines_)
+		for(auto& entry : pass.second)
+			if(entry.second.pending.valid())
+				entry.second.pipeline = {device(), entry.second.pending.get()};
+}
 
-		vk::ImageView iv = dummyTexture_.viewableImage().vkImageView();
-		dlg_assert(iv);
-		if(data.texture != 0)
-			iv = texture(data.texture)->viewableImage().vkImageView();
+vk::Pipeline SharedResources::pipeline(vk::RenderPass renderPass, std::uint32_t key)
+{
+	// created pipelines are only looked up, so recording threads can call this
+	// after resolvePipelines
+	for(auto& pass : pipelines_) {
+		if(pass.first != renderPass) continue;
+		auto it = pass.second.find(key);
+		if(it != pass.second.end() && it->second.pipeline)
+			return it->second.pipeline;
+	}
 
-		auto layout = vk::ImageLayout::general; //XXX
-		descUpdate.imageSampler({{{}, iv, layout}});
+	preparePipeline(renderPass, key);
+	for(auto& pass : pipelines_) {
+		if(pass.first != renderPass) continue;
+		auto& entry = pass.second[key];
+		if(!entry.pipeline)
+			entry.pipeline = {device(), entry.pending.get()};
 
-		descUpdate.apply();
+		return entry.pipeline;
 	}
 
-	update.apply()->finish();
+	return {};
+}
 
-	//vertex
-	vpp::BufferUpdate vupdate(vertexBuffer_, vpp::BufferLayout::std140);
-	vupdate.add(vpp::raw(*vertices_.data(), vertices_.size()));
-	vupdate.apply()->finish();
+const vpp::RenderPass& SharedResources::swapchainRenderPass(vk::Format format)
+{
+	for(auto& pass : swapchainRenderPasses_)
+		if(pass.first == format)
+			return pass.second;
+
+	// deque, references to the render passes stay valid
+	auto renderPass = createRenderPass(device(), format, settings_.sampleCount,
+		vk::ImageLayout::presentSrcKHR);
+	swapchainRenderPasses_.emplace_back(format, std::move(renderPass));
+	return swapchainRenderPasses_.back().second;
+}
 
-	//render
-	if(swapchain_) {
-		renderer_.renderBlock(*presentQueue_);
-	} else {
-		vk::beginCommandBuffer(commandBuffer_, {});
+const TextureSlot* SharedResources::textureSlot(unsigned int id) const
+{
+	// for id 0 the index wraps around and is therefore always out of range
+	auto index = (id & textureIndexMask) - 1;
+	if(index >= textures_.size()) return nullptr;
 
-		vk::ClearValue clearValues[2] {};
-		clearValues[0].color = {0.f, 0.f, 0.f, 1.0f};
-		clearValues[1].depthStencil = {1.f, 0};
+	auto& slot = textures_[index];
+	if(!slot.used || slot.generation != (id >> textureIndexBits)) return nullptr;
+	return &slot;
+}
+
+void SharedResources::textureChanged(unsigned int id)
+{
+	// frames drawing the texture can no longer be elided
+	if(textureSlot(id))
+		++textures_[(id & textureIndexMask) - 1].version;
+}
+
+const Texture* SharedResources::texture(unsigned int id) const
+{
+	auto* slot = textureSlot(id);
+	return slot ? &slot->texture : nullptr;
+}
+
+Texture* SharedResources::texture(unsigned int id)
+{
+	return const_cast<Texture*>(static_cast<const SharedResources&>(*this).texture(id));
+}
+
+vpp::DescriptorSet SharedResources::createTextureSet(const Texture& texture)
+{
+	constexpr auto setsPerPool = 64u;
+
+	vpp::DescriptorSet set;
+	if(!freeTextureSets_.empty()) {
+		set = std::move(freeTextureSets_.back());
+		freeTextureSets_.pop_back();
+	} else {
+		if(texturePools_.empty() || texturePoolUsed_ == setsPerPool) {
+			vk::DescriptorPoolSize poolSize;
+			poolSize.type = vk::DescriptorType::combinedImageSampler;
+			poolSize.descriptorCount = setsPerPool;
+
+			vk::DescriptorPoolCreateInfo poolInfo;
+			poolInfo.poolSizeCount = 1;
+			poolInfo.pPoolSizes = &poolSize;
+			poolInfo.maxSets = setsPerPool;
+
+			texturePools_.emplace_back(device(), poolInfo);
+			texturePoolUsed_ = 0;
+		}
+
+		set = {textureLayout_, texturePools_.back()};
+		++texturePoolUsed_;
+	}
+
+	vpp::DescriptorSetUpdate update(set);
+	update.imageSampler({{{}, texture.viewableImage().vkImageView(), texture.layout()}});
+	update.apply();
+
+	return set;
+}
+
+//Renderer
+Renderer::Renderer(const vpp::Swapchain& swapchain, const vpp::Queue* presentQueue,
+	const RendererSettings& settings) : vpp::Resource(swapchain.device()),
+		shared_(settings.sharedResources), swapchain_(&swapchain),
+		presentQueue_(presentQueue), settings_(settings)
+{
+	if(!shared_) shared_ = std::make_shared<SharedResources>(swapchain.device(), settings);
+
+	// all renderers for swapchains of the same format use the same render pass
+	renderPass_ = &shared_->swapchainRenderPass(swapchain.format());
+	renderPassHandle_ = *renderPass_;
+	init();
+	initSwapchainRenderer();
+}
+
+void Renderer::initSwapchainRenderer()
+{
+	auto& swapchain = *swapchain_;
+	auto impl = std::make_unique<RenderImpl>();
+	impl->renderer = this;
+	impl->swapchainRenderer = &renderer_;
+
+	auto attachmentInfo = vpp::ViewableImage::defaultDepth2D();
+	attachmentInfo.imgInfo.format = vk::Format::s8Uint;
+	attachmentInfo.viewInfo.format = vk::Format::s8Uint;
+	attachmentInfo.viewInfo.subresourceRange.aspectMask = vk::ImageAspectBits::stencil;
+	attachmentInfo.imgInfo.samples = settings_.sampleCount;
+
+	// with multisampling the swapchain image is only the resolve target
+	std::vector<vpp::ViewableImage::CreateInfo> attachments {attachmentInfo};
+	if(settings_.sampleCount != vk::SampleCountBits::e1) {
+		auto colorInfo = vpp::ViewableImage::defaultColor2D();
+		colorInfo.imgInfo.format = swapchain.format();
+		colorInfo.viewInfo.format = swapchain.format();
+		colorInfo.imgInfo.samples = settings_.sampleCount;
+		colorInfo.imgInfo.usage = vk::ImageUsageBits::colorAttachment |
+			vk::ImageUsageBits::transientAttachment;
+		attachments.push_back(colorInfo);
+	}
+
+	vpp::SwapchainRenderer::CreateInfo info {*renderPass_, 0, attachments};
+	renderer_ = {swapchain, info, std::move(impl)};
+}
+
+Renderer::Renderer(const vpp::Framebuffer& framebuffer, vk::RenderPass rp,
+	const RendererSettings& settings) : vpp::Resource(framebuffer.device()),
+		shared_(settings.sharedResources), framebuffer_(&framebuffer),
+		renderPassHandle_(rp), settings_(settings)
+{
+	if(!shared_) shared_ = std::make_shared<SharedResources>(framebuffer.device(), settings);
+
+	init();
+	for(auto& frame : frames_)
+		frame.commandBuffer = device().commandProvider().get(renderQueue_->family());
+}
+
+
+Renderer::~Renderer()
+{
+	// the device may still use resources of frames in flight
+	wait();
+	detach();
+}
+
+void Renderer::init()
+{
+	if(&shared_->device() != &device())
+		throw std::invalid_argument("vvg::Renderer::init: sharedResources of another device");
+
+	// the settings the shared resources were created for are used
+	auto& shared = shared_->settings();
+	settings_.pushConstants = shared.pushConstants;
+	settings_.textureArraySize = shared.textureArraySize;
+	settings_.indexedGeometry = shared.indexedGeometry;
+	settings_.packedVertices = shared.packedVertices;
+	settings_.sampleCount = shared.sampleCount;
+	settings_.pipelineCacheDirectory = shared.pipelineCacheDirectory;
+	settings_.sharedResources = shared_;
+	edgeAA_ = shared_->edgeAA_;
+	vertexStride_ = settings_.packedVertices ? sizeof(PackedVertex) : sizeof(NVGvertex);
+
+	// frames
+	if(settings_.framesInFlight == 0)
+		throw std::invalid_argument("vvg::Renderer::init: framesInFlight must not be 0");
+
+	frames_.resize(settings_.framesInFlight);
+
+	// queues
+	renderQueue_ = device().queue(vk::QueueBits::graphics);
+
+	if(swapchain_ && !presentQueue_) {
+		auto surface = swapchain_->vkSurface();
+		auto supported = vpp::supportedQueueFamilies(vkInstance(), surface, vkPhysicalDevice());
+		for(auto q : supported)
+			if((presentQueue_ = device().queue(q)))
+				break;
+
+		if(!presentQueue_)
+			throw std::runtime_error("vvg::Renderer::init: cannot find present queue");
+	}
+
+	// every frame needs exactly one uniform descriptor set and one texture array set
+	auto arraySize = settings_.textureArraySize;
+	vk::DescriptorPoolSize framePoolSizes[2] = {
+		{vk::DescriptorType::uniformBufferDynamic, 1},
+		{vk::DescriptorType::combinedImageSampler, arraySize}
+	};
+
+	vk::DescriptorPoolCreateInfo framePoolInfo;
+	framePoolInfo.poolSizeCount = arraySize ? 2 : 1;
+	framePoolInfo.pPoolSizes = framePoolSizes;
+	framePoolInfo.maxSets = arraySize ? 2 : 1;
+
+	for(auto& frame : frames_)
+		frame.descriptorPool = {device(), framePoolInfo};
+
+	// timestamps are written on the queue the frames are submitted to
+	if(settings_.gpuTimings) {
+		auto& queue = swapchain_ ? *presentQueue_ : *renderQueue_;
+		auto families = vk::getPhysicalDeviceQueueFamilyProperties(vkPhysicalDevice());
+		if(families[queue.family()].timestampValidBits == 0) {
+			dlg_warn("vvg::Renderer::init: queue does not support timestamps");
+			settings_.gpuTimings = false;
+		}
+	}
+
+	if(settings_.gpuTimings) {
+		timestampPeriod_ = device().properties().limits.timestampPeriod;
+		for(auto& frame : frames_)
+			frame.timestampPool = {device(), timestampQueryCount};
+	}
+
+	// the pipelines needed by nearly every frame (unscissored solid fills and strokes
+	// and text) are created in the background while the application builds its first frame.
+	// All others are only created when a frame uses them.
+	auto text = typeTexture | (texTypeA << 2);
+	auto prepare = [&](PipelineType type, std::uint32_t variant) {
+		auto key = pipelineKey(type, variant, edgeAA_, blendAlpha_);
+		shared_->preparePipeline(vkRenderPass(), key);
+	};
+
+	if(settings_.indexedGeometry) {
+		prepare(pipelineList, typeColor);
+		prepare(pipelineList, text);
+	} else {
+		prepare(pipelineFan, typeColor);
+		prepare(pipelineStrip, typeColor);
+		prepare(pipelineList, text);
+	}
+
+	// textures deleted from now on may be used by this renderer
+	shared_->renderers_.push_back(this);
+}
+
+void Renderer::detach()
+{
+	if(!shared_)
+		return;
+
+	auto& renderers = shared_->renderers_;
+	renderers.erase(std::remove(renderers.begin(), renderers.end(), this), renderers.end());
+
+	// the handle of a destroyed render pass may be reused for an incompatible one,
+	// so pipelines for render passes that are no longer used are destroyed
+	auto used = [&](vk::RenderPass rp) {
+		for(auto* renderer : renderers)
+			if(renderer->vkRenderPass() == rp)
+				return true;
+		for(auto& pass : shared_->swapchainRenderPasses_)
+			if(pass.second.vkHandle() == rp)
+				return true;
+		return false;
+	};
+
+	auto& pipelines = shared_->pipelines_;
+	for(auto it = pipelines.begin(); it != pipelines.end();) {
+		if(used(it->first)) {
+			++it;
+			continue;
+		}
+
+		for(auto& entry : it->second)
+			if(entry.second.pending.valid())
+				entry.second.pipeline = {device(), entry.second.pending.get()};
+		it = pipelines.erase(it);
+	}
+}
+
+void Renderer::preparePipelines()
+{
+	// starts creating all pipelines the frame needs at once, recording then only waits
+	// for the ones that are not finished yet
+	auto prepare = [&](const DrawData& data) {
+		auto prepareType = [&](PipelineType type) {
+			auto key = pipelineKey(type, data.variant, edgeAA_, blendAlpha_);
+			shared_->preparePipeline(vkRenderPass(), key);
+		};
+
+		if(data.stencilFill) {
+			prepareType(pipelineFillStencil);
+			prepareType(pipelineFillFringe);
+			prepareType(pipelineFillCover);
+		} else if(settings_.indexedGeometry) {
+			prepareType(pipelineList);
+		} else {
+			for(auto& path : data.paths) {
+				if(path.fillCount > 0) prepareType(pipelineFan);
+				if(path.strokeCount > 0) prepareType(pipelineStrip);
+			}
+
+			if(data.triangleCount > 0) prepareType(pipelineList);
+		}
+	};
+
+	for(auto& data : drawDatas_) {
+		if(!data.operation) {
+			prepare(data);
+			continue;
+		}
+
+		for(auto& draw : data.operation->draws_)
+			prepare(draw);
+	}
+}
+
+void Renderer::updateTextureArray(RenderFrame& frame)
+{
+	// unused slots are filled with the dummy texture
+	// the whole array is only written when the set is first used
+	auto& shared = *shared_;
+	auto count = static_cast<unsigned int>(shared.textures_.size());
+	if(!frame.textureArraySet) {
+		frame.textureArraySet = {shared.textureLayout_, frame.descriptorPool};
+		count = settings_.textureArraySize;
+		++stats_.descriptorSetsAllocated;
+	}
+
+	auto& dummy = shared.dummyTexture_;
+	auto dummyView = dummy.viewableImage().vkImageView();
+	std::vector<vk::DescriptorImageInfo> infos(count, {{}, dummyView, dummy.layout()});
+
+	// the index of a texture in the registry is also its slot in the array
+	for(auto i = 0u; i < shared.textures_.size(); ++i) {
+		if(shared.textures_[i].used) {
+			auto& tex = shared.textures_[i].texture;
+			infos[i].imageView = tex.viewableImage().vkImageView();
+			infos[i].imageLayout = tex.layout();
+		}
+	}
+
+	vpp::DescriptorSetUpdate update(frame.textureArraySet);
+	update.imageSampler(infos);
+	update.apply();
+
+	frame.textureArrayVersion = shared.textureArrayVersion_;
+	frame.resourceVersion = ++resourceVersion_;
+}
+
+unsigned int Renderer::createTexture(vk::Format format, unsigned int w, unsigned int h,
+	const std::uint8_t* data, vk::ImageUsageFlags usage)
+{
+	auto& shared = *shared_;
+	unsigned int index;
+	if(!shared.freeTextureSlots_.empty()) {
+		index = shared.freeTextureSlots_.back();
+		shared.freeTextureSlots_.pop_back();
+	} else {
+		auto max = settings_.textureArraySize ? settings_.textureArraySize : maxTextures;
+		if(shared.textures_.size() >= max) {
+			dlg_warn("vvg::Renderer::createTexture: too many textures");
+			return 0;
+		}
+
+		index = static_cast<unsigned int>(shared.textures_.size());
+		shared.textures_.emplace_back();
+	}
+
+	auto& slot = shared.textures_[index];
+	auto id = ((slot.generation << textureIndexBits) | (index + 1));
+
+	// the layout is initialized with the next flushed frame, together with the uploads
+	slot.texture = {device(), id, vk::Extent2D{w, h}, format, nullptr, false, usage};
+	slot.used = true;
+	shared.pendingLayouts_.push_back(id);
+
+	if(settings_.textureArraySize) {
+		++shared.textureArrayVersion_;
+	} else {
+		// sets of destroyed textures are reused and not allocated again
+		if(shared.freeTextureSets_.empty())
+			++stats_.descriptorSetsAllocated;
+		slot.descriptorSet = shared.createTextureSet(slot.texture);
+	}
+
+	// the initial data is uploaded like every other update
+	if(data)
+		updateTexture(id, {0, 0}, {w, h}, data);
+
+	return id;
+}
+
+bool Renderer::deleteTexture(unsigned int id)
+{
+	auto& shared = *shared_;
+	if(!shared.textureSlot(id)) return false;
+
+	// frames in flight of all renderers sharing the texture may still reference it,
+	// destroyed when they are finished. Texture array slots can be reused immediately
+	// since every frame has its own set
+	auto index = (id & textureIndexMask) - 1;
+	auto& slot = shared.textures_[index];
+	auto garbage = std::make_shared<TextureGarbage>();
+	garbage->shared = shared_;
+	garbage->texture = std::move(slot.texture);
+	if(settings_.textureArraySize) ++shared.textureArrayVersion_;
+	else garbage->descriptorSet = std::move(slot.descriptorSet);
+
+	for(auto* renderer : shared.renderers_)
+		renderer->deletedTextures_.push_back(garbage);
+
+	slot.texture = {};
+	slot.used = false;
+	slot.generation = (slot.generation + 1) & textureGenerationMask;
+	shared.freeTextureSlots_.push_back(index);
+
+	return true;
+}
+
+bool Renderer::updateTexture(unsigned int id, const vk::Offset2D& offset,
+	const vk::Extent2D& extent, const std::uint8_t* data)
+{
+	auto& shared = *shared_;
+	auto* tex = texture(id);
+	if(!tex || !data || offset.x < 0 || offset.y < 0) return false;
+	if(offset.x + extent.width > tex->width() || offset.y + extent.height > tex->height())
+		return false;
+
+	if(extent.width == 0 || extent.height == 0)
+		return true;
+
+	// copy the given region into the tightly packed staging data
+	auto pixelSize = formatSize(tex->format());
+	auto rowSize = extent.width * pixelSize;
+	auto pitch = tex->width() * pixelSize;
+
+	auto dataOffset = shared.uploadData_.size();
+	shared.uploadData_.resize(dataOffset + rowSize * extent.height);
+
+	auto src = data + offset.y * pitch + offset.x * pixelSize;
+	auto dst = shared.uploadData_.data() + dataOffset;
+	for(auto i = 0u; i < extent.height; ++i)
+		std::memcpy(dst + i * rowSize, src + i * pitch, rowSize);
+
+	// buffer offsets for image copies must be a multiple of 4
+	shared.uploadData_.resize(((shared.uploadData_.size() + 3) / 4) * 4);
+	shared.uploads_.push_back({id, offset, extent, dataOffset});
+	shared.textureChanged(id);
+
+	return true;
+}
+
+void Renderer::upload(RenderFrame& frame, const vpp::Queue& queue)
+{
+	auto& shared = *shared_;
+	auto bits = device().memoryTypeBits(vk::MemoryPropertyBits::hostVisible);
+	if(frame.uploadBuffer.memorySize() < shared.uploadData_.size()) {
+		vk::BufferCreateInfo bufInfo;
+		bufInfo.usage = vk::BufferUsageBits::transferSrc;
+		bufInfo.size = shared.uploadData_.size();
+		frame.uploadBuffer = {device(), bufInfo, bits};
+		++stats_.bufferReallocations;
+	}
+
+	stats_.textureBytes += shared.uploadData_.size();
+
+	if(!shared.uploadData_.empty())
+		writeBuffer(frame.uploadBuffer, 0, shared.uploadData_.data(), shared.uploadData_.size());
+
+	if(!frame.uploadCommandBuffer)
+		frame.uploadCommandBuffer = device().commandProvider().get(queue.family());
+
+	// textures created since the last upload are still in the undefined layout
+	// textures deleted since then are skipped
+	std::vector<const Texture*> created;
+	if(shared.dummyPending_)
+		created.push_back(&shared.dummyTexture_);
+	for(auto id : shared.pendingLayouts_)
+		if(auto* tex = texture(id))
+			created.push_back(tex);
+
+	auto isCreated = [&](const Texture* tex) {
+		return std::find(created.begin(), created.end(), tex) != created.end();
+	};
+
+	std::vector<vk::ImageMemoryBarrier> barriers;
+	std::vector<vk::ImageLayout> layouts; // layout of the barriers image when sampled
+	std::vector<std::pair<const Texture*, vk::BufferImageCopy>> copies;
+	for(auto& upload : shared.uploads_) {
+		auto* tex = texture(upload.texture);
+		if(!tex) continue;
+
+		vk::BufferImageCopy copy;
+		copy.bufferOffset = upload.dataOffset;
+		copy.imageSubresource = {vk::ImageAspectBits::color, 0, 0, 1};
+		copy.imageOffset = {upload.offset.x, upload.offset.y, 0};
+		copy.imageExtent = {upload.extent.width, upload.extent.height, 1};
+		copies.push_back({tex, copy});
+
+		// only one barrier per image, multiple layout transitions would conflict
+		auto image = tex->viewableImage().vkImage();
+		auto it = std::find_if(barriers.begin(), barriers.end(),
+			[&](const auto& barrier) { return barrier.image == image; });
+		if(it != barriers.end())
+			continue;
+
+		// linear images stay in the general layout
+		vk::ImageMemoryBarrier barrier;
+		barrier.image = image;
+		barrier.oldLayout = tex->layout();
+		barrier.newLayout = transferLayout(*tex);
+		barrier.srcAccessMask = vk::AccessBits::shaderRead;
+		barrier.dstAccessMask = vk::AccessBits::transferWrite;
+		barrier.subresourceRange = {vk::ImageAspectBits::color, 0, 1, 0, 1};
+
+		if(isCreated(tex)) {
+			barrier.oldLayout = vk::ImageLayout::undefined;
+			barrier.srcAccessMask = {};
+		}
+
+		barriers.push_back(barrier);
+		layouts.push_back(tex->layout());
+	}
+
+	// created textures without any upload only need their initial transition
+	std::vector<vk::ImageMemoryBarrier> layoutBarriers;
+	for(auto* tex : created) {
+		auto image = tex->viewableImage().vkImage();
+		auto it = std::find_if(barriers.begin(), barriers.end(),
+			[&](const auto& barrier) { return barrier.image == image; });
+		if(it != barriers.end())
+			continue;
+
+		vk::ImageMemoryBarrier barrier;
+		barrier.image = image;
+		barrier.oldLayout = vk::ImageLayout::undefined;
+		barrier.newLayout = tex->layout();
+		barrier.dstAccessMask = vk::AccessBits::shaderRead;
+		barrier.subresourceRange = {vk::ImageAspectBits::color, 0, 1, 0, 1};
+		layoutBarriers.push_back(barrier);
+	}
+
+	shared.uploads_.clear();
+	shared.uploadData_.clear();
+	shared.pendingLayouts_.clear();
+	shared.dummyPending_ = false;
+	if(copies.empty() && layoutBarriers.empty())
+		return;
+
+	// previous frames may still read the textures, and this frame must see the new data
+	auto& cmdBuffer = frame.uploadCommandBuffer;
+	vk::beginCommandBuffer(cmdBuffer, {});
+	if(!barriers.empty())
+		vk::cmdPipelineBarrier(cmdBuffer, vk::PipelineStageBits::fragmentShader,
+			vk::PipelineStageBits::transfer, {}, {}, {}, barriers);
+
+	for(auto& copy : copies)
+		vk::cmdCopyBufferToImage(cmdBuffer, frame.uploadBuffer,
+			copy.first->viewableImage().vkImage(), transferLayout(*copy.first), {copy.second});
+
+	for(auto i = 0u; i < barriers.size(); ++i) {
+		auto& barrier = barriers[i];
+		barrier.oldLayout = barrier.newLayout;
+		barrier.newLayout = layouts[i];
+		barrier.srcAccessMask = vk::AccessBits::transferWrite;
+		barrier.dstAccessMask = vk::AccessBits::shaderRead;
+	}
+
+	barriers.insert(barriers.end(), layoutBarriers.begin(), layoutBarriers.end());
+	vk::cmdPipelineBarrier(cmdBuffer, vk::PipelineStageBits::transfer,
+		vk::PipelineStageBits::fragmentShader, {}, {}, {}, barriers);
+	vk::endCommandBuffer(cmdBuffer);
+
+	// submitted on the render queue before the frame, so waiting for the frame
+	// also waits for the upload
+	device().submitManager().add(queue, {cmdBuffer});
+	device().submitManager().submit(queue);
+}
+
+void Renderer::wait()
+{
+	for(auto& frame : frames_)
+		finishFrame(frame);
+
+	deletedTextures_.clear();
+}
+
+void Renderer::resize(const vpp::Swapchain* swapchain)
+{
+	if(!swapchain_)
+		throw std::runtime_error("vvg::Renderer::resize: not rendering on a swapchain");
+
+	// the old framebuffers and command buffers may still be used by frames in flight
+	wait();
+	renderer_ = {};
+	if(swapchain) swapchain_ = swapchain;
+
+	// the render pass only changes with the format, its pipelines are created on demand
+	renderPass_ = &shared_->swapchainRenderPass(swapchain_->format());
+	renderPassHandle_ = *renderPass_;
+	initSwapchainRenderer();
+
+	// the recordings of the old images are gone and the next frame must not be elided
+	imageRecordHashes_.clear();
+	imageTimestampGroups_.clear();
+	imageFrames_.clear();
+	lastContentHash_ = {};
+}
+
+void Renderer::finishFrame(RenderFrame& frame)
+{
+	if(frame.submitted) {
+		frame.state.wait();
+		frame.submitted = false;
+		frameFinished(static_cast<unsigned int>(&frame - frames_.data()));
+	}
+
+	if(frame.timedFrame)
+		readTimestamps(frame);
+
+	// no frame in flight can reference the deleted textures anymore
+	frame.garbage.clear();
+}
+
+void Renderer::readTimestamps(RenderFrame& frame)
+{
+	// the frame was waited for, so the results are available
+	auto count = queryFirstGroup + static_cast<unsigned int>(frame.timestampGroups.size());
+	std::uint64_t timestamps[timestampQueryCount];
+	auto res = vk::getQueryPoolResults(device(), frame.timestampPool, 0, count,
+		count * sizeof(std::uint64_t), timestamps, sizeof(std::uint64_t),
+		vk::QueryResultBits::e64);
+
+	auto number = frame.timedFrame;
+	frame.timedFrame = 0;
+	if(res != vk::Result::success || number < gpuTimings_.frame)
+		return;
+
+	auto ms = [&](unsigned int from, unsigned int to) {
+		return (timestamps[to] - timestamps[from]) * double(timestampPeriod_) / 1000000.0;
+	};
+
+	GpuTimings timings;
+	timings.frame = number;
+	timings.total = ms(queryFrameStart, queryFrameEnd);
+
+	// every group ends where the next one starts
+	auto groupCount = frame.timestampGroups.size();
+	for(auto i = 0u; i < groupCount; ++i) {
+		auto start = queryFirstGroup + i;
+		auto end = (i + 1 < groupCount) ? start + 1 : queryDrawsEnd;
+		switch(frame.timestampGroups[i]) {
+			case drawFill: timings.fills += ms(start, end); break;
+			case drawStroke: timings.strokes += ms(start, end); break;
+			case drawTriangles: timings.triangles += ms(start, end); break;
+		}
+	}
+
+	gpuTimings_ = timings;
+}
+
+const vpp::Buffer& Renderer::uniformBuffer() const
+{
+	return frames_[frameIndex_].uniformBuffer;
+}
+
+const vpp::Buffer& Renderer::vertexBuffer() const
+{
+	return frames_[frameIndex_].vertexBuffer;
+}
+
+const vpp::DescriptorSet& Renderer::uniformDescriptorSet() const
+{
+	return frames_[frameIndex_].uniformSet;
+}
+
+const vpp::DescriptorSet& Renderer::textureDescriptorSet(unsigned int id) const
+{
+	if(settings_.textureArraySize)
+		return frames_[frameIndex_].textureArraySet;
+
+	auto* slot = shared_->textureSlot(id);
+	return slot ? slot->descriptorSet : shared_->dummyTextureSet_;
+}
+
+const vpp::CommandBuffer& Renderer::commandBuffer() const
+{
+	return frames_[frameIndex_].commandBuffer;
+}
+
+void Renderer::start(unsigned int width, unsigned int height)
+{
+	// store (and set) viewport in some way
+	width_ = width;
+	height_ = height;
+
+	vertices_.clear();
+	drawDatas_.clear();
+	stats_ = {};
+}
+
+void Renderer::cancel()
+{
+}
+
+void Renderer::flush()
+{
+	// empty frames are not presented, but they clear framebuffers (e.g. offscreen
+	// images and layers)
+	frameElided_ = false;
+	if(drawDatas_.empty() && swapchain_)
+		return;
+
+	// frames with the same content as the last rendered one are dropped completely,
+	// the last presented frame stays visible. Pending uploads change texture contents,
+	// so such frames are always rendered.
+	if(settings_.elideIdenticalFrames) {
+		auto hash = contentHash();
+		if(hash == lastContentHash_ && shared_->uploads_.empty()) {
+			frameElided_ = true;
+			vertices_.clear();
+			drawDatas_.clear();
+			return;
+		}
+
+		lastContentHash_ = hash;
+	}
+
+	// wait until the device has finished the last frame that used these resources
+	auto& frame = frames_[frameIndex_];
+	finishFrame(frame);
+
+	auto uploadStart = Clock::now();
+	stats_.draws = drawDatas_.size();
+	stats_.vertices = vertexCount();
+
+	// allocate buffers
+	auto stride = uniformStride(device());
+	auto uniformSize = stride * drawDatas_.size();
+
+	// in the push constant mode the uniform buffer is still bound but never read
+	if(settings_.pushConstants)
+		uniformSize = stride;
+
+	auto bits = device().memoryTypeBits(vk::MemoryPropertyBits::hostVisible);
+
+	if(frame.uniformBuffer.memorySize() < uniformSize) {
+		vk::BufferCreateInfo bufInfo;
+		bufInfo.usage = vk::BufferUsageBits::uniformBuffer;
+		bufInfo.size = uniformSize;
+		frame.uniformBuffer = {device(), bufInfo, bits};
+		frame.resourceVersion = ++resourceVersion_;
+		++stats_.bufferReallocations;
+
+		// the descriptor only has to be updated when the buffer changes
+		if(!frame.uniformSet) {
+			frame.uniformSet = {shared_->uniformLayout_, frame.descriptorPool};
+			++stats_.descriptorSetsAllocated;
+		}
+
+		vpp::DescriptorSetUpdate descUpdate(frame.uniformSet);
+		descUpdate.uniformDynamic({{frame.uniformBuffer, 0, sizeof(UniformData)}});
+		descUpdate.apply();
+	}
+
+	auto vertexSize = vertices_.size();
+	if(frame.vertexBuffer.memorySize() < vertexSize) {
+		vk::BufferCreateInfo bufInfo;
+		bufInfo.usage = vk::BufferUsageBits::vertexBuffer;
+		bufInfo.size = vertexSize;
+		frame.vertexBuffer = {device(), bufInfo, bits};
+		frame.resourceVersion = ++resourceVersion_;
+		++stats_.bufferReallocations;
+	}
+
+	// update
+	// the buffers are host visible, so they are written directly without
+	// waiting for any device work
+	if(!settings_.pushConstants) {
+		auto map = frame.uniformBuffer.memoryMap();
+		auto offset = std::size_t(0);
+		for(auto& data : drawDatas_) {
+			if(data.operation) continue;
+			std::memcpy(map.ptr() + offset, &data.uniformData, sizeof(UniformData));
+			data.uniformOffset = offset;
+			offset += stride;
+			stats_.uniformBytes += sizeof(UniformData);
+		}
+
+		if(!map.coherent()) map.flush();
+	}
+
+	// operations only have to be updated if their parameters changed
+	for(auto& data : drawDatas_)
+		if(data.operation)
+			updateOperation(*data.operation);
+
+	if(settings_.textureArraySize && frame.textureArrayVersion != shared_->textureArrayVersion_)
+		updateTextureArray(frame);
+
+	//vertex
+	if(vertexSize > 0)
+		writeBuffer(frame.vertexBuffer, 0, vertices_.data(), vertexSize);
+	stats_.vertexBytes += vertexSize;
+
+	//index
+	// 16 bit indices are used when they can address all vertices
+	if(settings_.indexedGeometry) {
+		generateIndices(drawDatas_, indices_);
+
+		auto small = vertexCount() <= 0x10000;
+		auto indexSize = indices_.size() * (small ? 2 : 4);
+		frame.indexType = small ? vk::IndexType::uint16 : vk::IndexType::uint32;
+
+		if(frame.indexBuffer.memorySize() < indexSize) {
+			vk::BufferCreateInfo bufInfo;
+			bufInfo.usage = vk::BufferUsageBits::indexBuffer;
+			bufInfo.size = indexSize;
+			frame.indexBuffer = {device(), bufInfo, bits};
+			frame.resourceVersion = ++resourceVersion_;
+			++stats_.bufferReallocations;
+		}
+
+		stats_.vertexBytes += indexSize;
+
+		if(small && indexSize > 0) {
+			std::vector<std::uint16_t> indices(indices_.begin(), indices_.end());
+			writeBuffer(frame.indexBuffer, 0, indices.data(), indexSize);
+		} else if(indexSize > 0) {
+			writeBuffer(frame.indexBuffer, 0, indices_.data(), indexSize);
+		}
+	}
+
+	//textures
+	auto& queue = swapchain_ ? *presentQueue_ : *renderQueue_;
+	if(!shared_->uploads_.empty() || !shared_->pendingLayouts_.empty() || shared_->dummyPending_)
+		upload(frame, queue);
+
+	stats_.uploadTime += millisecondsSince(uploadStart);
+
+	//render
+	// recorded command buffers are reused if the structure of the frame did not change
+	auto renderStart = Clock::now();
+	preparePipelines();
+	recordHash_ = structureHash(frame);
+	++frameCount_;
+
+	// the query pool of swapchain frames is reset before the render pass
+	auto timed = settings_.gpuTimings;
+	if(timed && swapchain_) {
+		if(!frame.timestampReset) {
+			frame.timestampReset = device().commandProvider().get(queue.family());
+			vk::beginCommandBuffer(frame.timestampReset, {});
+			vk::cmdResetQueryPool(frame.timestampReset, frame.timestampPool, 0,
+				timestampQueryCount);
+			vk::endCommandBuffer(frame.timestampReset);
+		}
+
+		device().submitManager().add(queue, {frame.timestampReset});
+		device().submitManager().submit(queue);
+	}
+
+	// the swapchain recording time is measured by RenderImpl, the rest is submitting
+	if(swapchain_) {
+		auto recordTime = stats_.recordTime;
+		frame.state = renderer_.render(queue);
+		stats_.submitTime += millisecondsSince(renderStart) - (stats_.recordTime - recordTime);
+	} else if(reuseRecording(frame.recordHash)) {
+		device().submitManager().add(queue, {frame.commandBuffer}, &frame.state);
+		device().submitManager().submit(queue);
+		stats_.submitTime += millisecondsSince(renderStart);
+	} else {
+		auto& cmdBuffer = frame.commandBuffer;
+		vk::beginCommandBuffer(cmdBuffer, {});
+
+		auto writeTimestamp = [&](unsigned int query) {
+			vk::cmdWriteTimestamp(cmdBuffer, vk::PipelineStageBits::bottomOfPipe,
+				frame.timestampPool, query);
+		};
+
+		if(timed) {
+			vk::cmdResetQueryPool(cmdBuffer, frame.timestampPool, 0, timestampQueryCount);
+			writeTimestamp(queryFrameStart);
+		}
+
+		// with multisampling the color attachment 2 is cleared instead of the resolve target
+		vk::ClearValue clearValues[3] {};
+		auto& color = clearColor_;
+		clearValues[0].color = {color[0], color[1], color[2], color[3]};
+		clearValues[1].depthStencil = {1.f, 0};
+		clearValues[2].color = clearValues[0].color;
+		auto multisampled = (settings_.sampleCount != vk::SampleCountBits::e1);
 
 		auto size = framebuffer_->size();
 
 		vk::RenderPassBeginInfo beginInfo;
 		beginInfo.renderPass = vkRenderPass();
 		beginInfo.renderArea = {{0, 0}, {size.width, size.height}};
-		beginInfo.clearValueCount = 2;
+		beginInfo.clearValueCount = multisampled ? 3 : 2;
 		beginInfo.pClearValues = clearValues;
 		beginInfo.framebuffer = *framebuffer_;
-		vk::cmdBeginRenderPass(commandBuffer_, beginInfo, vk::SubpassContents::eInline);
 
-		vk::Viewport viewport;
-		viewport.width = size.width;
-		viewport.height = size.height;
-		viewport.minDepth = 0.f;
-		viewport.maxDepth = 1.f;
-		vk::cmdSetViewport(commandBuffer_, 0, 1, viewport);
+		// large frames are split into chunks that are recorded in parallel into
+		// secondary command buffers, executed in order
+		auto chunks = std::size_t(1);
+		if(settings_.recordThreads > 1)
+			chunks = std::min<std::size_t>(settings_.recordThreads,
+				drawDatas_.size() / minRecordChunkSize);
+
+		// the draw groups are only measured when recording inline
+		frame.timestampGroups.clear();
+		if(chunks > 1) {
+			vk::cmdBeginRenderPass(cmdBuffer, beginInfo,
+				vk::SubpassContents::secondaryCommandBuffers);
+			recordParallel(frame, chunks);
+
+			std::vector<vk::CommandBuffer> buffers;
+			for(auto i = 0u; i < chunks; ++i)
+				buffers.push_back(frame.recordBuffers[i]);
+			vk::cmdExecuteCommands(cmdBuffer, buffers);
+			vk::cmdEndRenderPass(cmdBuffer);
+			if(timed) writeTimestamp(queryDrawsEnd);
+		} else {
+			vk::cmdBeginRenderPass(cmdBuffer, beginInfo, vk::SubpassContents::eInline);
+			recordViewport(cmdBuffer, size.width, size.height);
+
+			RecordState state;
+			if(timed) state.timestamps = frame.timestampPool;
+			recordRange(cmdBuffer, 0, drawDatas_.size(), state);
+			addRecordStats(stats_, state);
+			frame.timestampGroups = std::move(state.groups);
+
+			if(timed) writeTimestamp(queryDrawsEnd);
+			vk::cmdEndRenderPass(cmdBuffer);
+		}
+
+		recordAfterRenderPass(cmdBuffer, frameIndex_);
+		if(timed) writeTimestamp(queryFrameEnd);
+		vk::endCommandBuffer(cmdBuffer);
+		stats_.recordTime += millisecondsSince(renderStart);
 
-		//Update dynamic scissor state
-		vk::Rect2D scissor;
-		scissor.extent = {size.width, size.height};
-		scissor.offset = {0, 0};
-		vk::cmdSetScissor(commandBuffer_, 0, 1, scissor);
+		auto submitStart = Clock::now();
+		device().submitManager().add(queue, {cmdBuffer}, &frame.state);
+		device().submitManager().submit(queue);
+		stats_.submitTime += millisecondsSince(submitStart);
+	}
 
-		record(commandBuffer_);
+	// the textures deleted until now may be used by this or previous frames
+	frame.submitted = true;
+	if(timed) frame.timedFrame = frameCount_;
+	frameSubmitted(frameIndex_);
 
-		vk::cmdEndRenderPass(commandBuffer_);
-		vk::endCommandBuffer(commandBuffer_);
+	frame.garbage = std::move(deletedTextures_);
+	deletedTextures_.clear();
 
-		vpp::CommandExecutionState state;
-		device().submitManager().add(*renderQueue_, {commandBuffer_}, &state);
-		state.wait();
-	}
+	if(settings_.framesInFlight == 1)
+		finishFrame(frame);
+
+	frameIndex_ = (frameIndex_ + 1) % frames_.size();
 
 	//cleanup
 	vertices_.clear();
+	indices_.clear();
 	drawDatas_.clear();
 }
 
+void Renderer::tessellation(bool done)
+{
+	if(!done) tessellationStart_ = Clock::now();
+	else stats_.tessellationTime += millisecondsSince(tessellationStart_);
+}
+
+void Renderer::beginOperation(RenderOperation& operation)
+{
+	if(operation_) {
+		dlg_warn("vvg::Renderer::beginOperation: already capturing an operation");
+		return;
+	}
+
+	operation_ = &operation;
+	operationDrawStart_ = drawDatas_.size();
+	operationVertexStart_ = vertexCount();
+	operation.convexFills_ = 0;
+	operation.stencilFills_ = 0;
+}
+
+void Renderer::endOperation()
+{
+	if(!operation_) {
+		dlg_warn("vvg::Renderer::endOperation: no operation is captured");
+		return;
+	}
+
+	auto& operation = *operation_;
+	operation_ = nullptr;
+
+	// move the captured draws and vertices out of the current frame
+	auto drawStart = drawDatas_.begin() + operationDrawStart_;
+	auto vertexStart = vertices_.begin() + operationVertexStart_ * vertexStride_;
+	operation.draws_.assign(std::make_move_iterator(drawStart),
+		std::make_move_iterator(drawDatas_.end()));
+	std::vector<std::uint8_t> vertices(vertexStart, vertices_.end());
+	drawDatas_.erase(drawStart, drawDatas_.end());
+	vertices_.erase(vertexStart, vertices_.end());
+
+	// unused ranges are left at 0
+	auto base = operationVertexStart_;
+	auto rebase = [&](std::size_t& offset, std::size_t count) {
+		if(count > 0) offset -= base;
+	};
+
+	for(auto& draw : operation.draws_) {
+		for(auto& path : draw.paths) {
+			rebase(path.fillOffset, path.fillCount);
+			rebase(path.strokeOffset, path.strokeCount);
+		}
+
+		rebase(draw.triangleOffset, draw.triangleCount);
+		rebase(draw.coverOffset, draw.stencilFill);
+	}
+
+	operationDrawStart_ = 0;
+	operationVertexStart_ = 0;
+	operation.version_ = ++operationVersion;
+	operation.renderer_ = this;
+	operation.slotHashes_.assign(frames_.size(), 0);
+
+	if(operation.draws_.empty())
+		return;
+
+	// the geometry is written once, the uniform buffer has one slot per frame in flight
+	auto bits = device().memoryTypeBits(vk::MemoryPropertyBits::hostVisible);
+	auto createBuffer = [&](vpp::Buffer& buffer, vk::BufferUsageFlags usage, std::size_t size) {
+		vk::BufferCreateInfo bufInfo;
+		bufInfo.usage = usage;
+		bufInfo.size = size;
+		buffer = {device(), bufInfo, bits};
+		++stats_.bufferReallocations;
+	};
+
+	auto vertexSize = vertices.size();
+	if(vertexSize > 0) {
+		createBuffer(operation.vertexBuffer_, vk::BufferUsageBits::vertexBuffer, vertexSize);
+		writeBuffer(operation.vertexBuffer_, 0, vertices.data(), vertexSize);
+		stats_.vertexBytes += vertexSize;
+	}
+
+	if(settings_.indexedGeometry) {
+		std::vector<std::uint32_t> indices;
+		generateIndices(operation.draws_, indices);
+
+		auto indexSize = indices.size() * sizeof(std::uint32_t);
+		if(indexSize > 0) {
+			createBuffer(operation.indexBuffer_, vk::BufferUsageBits::indexBuffer, indexSize);
+			writeBuffer(operation.indexBuffer_, 0, indices.data(), indexSize);
+			stats_.vertexBytes += indexSize;
+		}
+	}
+
+	// in the push constant mode the uniform data is pushed when recording
+	if(!settings_.pushConstants) {
+		auto uniformSize = uniformStride(device()) * operation.draws_.size() * frames_.size();
+		createBuffer(operation.uniformBuffer_, vk::BufferUsageBits::uniformBuffer, uniformSize);
+
+		if(!operation.uniformSet_) {
+			vk::DescriptorPoolSize poolSize {vk::DescriptorType::uniformBufferDynamic, 1};
+
+			vk::DescriptorPoolCreateInfo poolInfo;
+			poolInfo.poolSizeCount = 1;
+			poolInfo.pPoolSizes = &poolSize;
+			poolInfo.maxSets = 1;
+
+			operation.descriptorPool_ = {device(), poolInfo};
+			operation.uniformSet_ = {shared_->uniformLayout_, operation.descriptorPool_};
+			++stats_.descriptorSetsAllocated;
+		}
+
+		vpp::DescriptorSetUpdate descUpdate(operation.uniformSet_);
+		descUpdate.uniformDynamic({{operation.uniformBuffer_, 0, sizeof(UniformData)}});
+		descUpdate.apply();
+	}
+}
+
+void Renderer::draw(RenderOperation& operation)
+{
+	if(operation_) {
+		dlg_warn("vvg::Renderer::draw: operations cannot be drawn into operations");
+		return;
+	}
+
+	// the uniform slots of the operation exist once per frame of the capturing renderer
+	if(operation.renderer_ != this) {
+		dlg_warn("vvg::Renderer::draw: operation was captured by another renderer");
+		return;
+	}
+
+	if(operation.empty())
+		return;
+
+	drawDatas_.emplace_back();
+	drawDatas_.back().operation = &operation;
+	stats_.convexFills += operation.convexFills_;
+	stats_.stencilFills += operation.stencilFills_;
+}
+
+void Renderer::updateOperation(RenderOperation& operation)
+{
+	if(settings_.pushConstants)
+		return;
+
+	// only the slot of the current frame is written and only if something changed
+	Hasher hash;
+	hash.add(operation.version_);
+	hash.add(width_);
+	hash.add(height_);
+	addParameters(hash, operation);
+
+	auto& slotHash = operation.slotHashes_[frameIndex_];
+	if(slotHash == hash.value)
+		return;
+
+	auto stride = uniformStride(device());
+	auto offset = frameIndex_ * operation.draws_.size() * stride;
+	Vec2 viewSize = {float(width_), float(height_)};
+
+	auto map = operation.uniformBuffer_.memoryMap();
+	for(auto& draw : operation.draws_) {
+		auto data = operationUniformData(operation, draw, viewSize);
+		std::memcpy(map.ptr() + offset, &data, sizeof(UniformData));
+		offset += stride;
+		stats_.uniformBytes += sizeof(UniformData);
+	}
+
+	if(!map.coherent()) map.flush();
+	slotHash = hash.value;
+}
+
+std::uint64_t Renderer::structureHash(const RenderFrame& frame) const
+{
+	// everything that is recorded into the command buffer, the contents of the buffers
+	// are not needed since they are written every frame
+	Hasher hash;
+	hash.add(frameIndex_);
+	hash.add(frame.resourceVersion);
+	hash.add(frame.indexType);
+	hash.add(indices_.empty());
+	hash.add(width_);
+	hash.add(height_);
+
+	if(framebuffer_) {
+		auto size = framebuffer_->size();
+		hash.add(size.width);
+		hash.add(size.height);
+	}
+
+	// texture ids contain their generation, so they also identify the descriptor set contents
+	hash.add(drawDatas_.size());
+	for(auto& data : drawDatas_) {
+		// operations are identified by their capture version
+		// in the push constant mode their parameters are part of the recording
+		if(data.operation) {
+			hash.add(data.operation->version_);
+			if(settings_.pushConstants)
+				addParameters(hash, *data.operation);
+			continue;
+		}
+
+		hash.add(data.texture);
+		hash.add(data.variant);
+		hash.add(data.kind);
+		hash.add(data.uniformOffset);
+		hash.add(data.stencilFill);
+		hash.add(data.coverOffset);
+		hash.add(data.triangleOffset);
+		hash.add(data.triangleCount);
+		hash.add(data.indexOffset);
+		hash.add(data.indexCount);
+		hash.add(data.stencilIndexCount);
+		hash.add(data.fringeIndexCount);
+
+		hash.add(data.paths.size());
+		if(!data.paths.empty())
+			hash.add(data.paths.data(), data.paths.size() * sizeof(Path));
+
+		if(settings_.pushConstants)
+			hash.add(pushData(data.uniformData));
+	}
+
+	// 0 is used for "not recorded"
+	return hash.value ? hash.value : 1;
+}
+
+std::uint64_t Renderer::contentHash() const
+{
+	Hasher hash;
+	hash.add(width_);
+	hash.add(height_);
+
+	// the contents of textures change without changing their handle
+	auto addTexture = [&](unsigned int id) {
+		auto* slot = shared_->textureSlot(id);
+		hash.add(id);
+		hash.add(slot ? slot->version : 0u);
+	};
+
+	hash.add(drawDatas_.size());
+	for(auto& data : drawDatas_) {
+		if(data.operation) {
+			hash.add(data.operation->version_);
+			addParameters(hash, *data.operation);
+			for(auto& draw : data.operation->draws_)
+				if(draw.texture) addTexture(draw.texture);
+			continue;
+		}
+
+		hash.add(data.uniformData);
+		addTexture(data.texture);
+		hash.add(data.stencilFill);
+		hash.add(data.coverOffset);
+		hash.add(data.triangleOffset);
+		hash.add(data.triangleCount);
+
+		hash.add(data.paths.size());
+		if(!data.paths.empty())
+			hash.add(data.paths.data(), data.paths.size() * sizeof(Path));
+	}
+
+	hash.add(vertices_.size());
+	if(!vertices_.empty())
+		hash.add(vertices_.data(), vertices_.size());
+
+	return hash.value;
+}
+
+bool Renderer::reuseRecording(std::uint64_t& recordHash)
+{
+	if(recordHash == recordHash_) {
+		++stats_.recordingsReused;
+		return true;
+	}
+
+	recordHash = recordHash_;
+	++stats_.recordingsRecorded;
+	return false;
+}
+
+void Renderer::generateIndices(std::vector<DrawData>& draws, std::vector<std::uint32_t>& indices)
+{
+	auto fan = [&](std::size_t offset, std::size_t count) {
+		auto first = static_cast<std::uint32_t>(offset);
+		for(auto i = 2u; i < count; ++i)
+			indices.insert(indices.end(), {first, first + i - 1, first + i});
+	};
+
+	auto strip = [&](std::size_t offset, std::size_t count) {
+		auto first = static_cast<std::uint32_t>(offset);
+		for(auto i = 2u; i < count; ++i)
+			indices.insert(indices.end(), {first + i - 2, first + i - 1, first + i});
+	};
+
+	indices.clear();
+	for(auto& data : draws) {
+		data.indexOffset = indices.size();
+
+		if(data.stencilFill) {
+			for(auto& path : data.paths)
+				fan(path.fillOffset, path.fillCount);
+			data.stencilIndexCount = indices.size() - data.indexOffset;
+
+			for(auto& path : data.paths)
+				strip(path.strokeOffset, path.strokeCount);
+			data.fringeIndexCount = indices.size() - data.indexOffset - data.stencilIndexCount;
+
+			strip(data.coverOffset, 4);
+			data.indexCount = indices.size() - data.indexOffset;
+			continue;
+		}
+
+		// the draw order of the paths and their fans and strips is kept
+		for(auto& path : data.paths) {
+			fan(path.fillOffset, path.fillCount);
+			strip(path.strokeOffset, path.strokeCount);
+		}
+
+		auto triangles = static_cast<std::uint32_t>(data.triangleOffset);
+		for(auto i = 0u; i < data.triangleCount; ++i)
+			indices.push_back(triangles + i);
+
+		data.indexCount = indices.size() - data.indexOffset;
+	}
+}
+
 void Renderer::fill(const NVGpaint& paint, const NVGscissor& scissor, float fringe,
 	const float* bounds, nytl::Span<const NVGpath> paths)
 {
-	unused(bounds);
 	auto& drawData = parsePaint(paint, scissor, fringe, fringe);
+	drawData.kind = drawFill;
 	drawData.paths.reserve(paths.size());
 
+	// a single convex path can be drawn directly, everything else needs the stencil buffer
+	drawData.stencilFill = !(paths.size() == 1 && paths[0].convex);
+
 	for(auto& path : paths)
 	{
 		drawData.paths.emplace_back();
-		drawData.paths.back().fillOffset = vertices_.size();
+		drawData.paths.back().fillOffset = vertexCount();
 		drawData.paths.back().fillCount = path.nfill;
-		vertices_.insert(vertices_.end(), path.fill, path.fill + path.nfill);
+		addVertices(path.fill, path.nfill);
 
 		if(edgeAA_ && path.nstroke > 0)
 		{
-			drawData.paths.back().strokeOffset = vertices_.size();
+			drawData.paths.back().strokeOffset = vertexCount();
 			drawData.paths.back().strokeCount = path.nstroke;
-			vertices_.insert(vertices_.end(), path.stroke, path.stroke + path.nstroke);
+			addVertices(path.stroke, path.nstroke);
 		}
 	}
+
+	// bounds: minX, minY, maxX, maxY
+	// the cover quad uses uv coordinates that result in full stroke alpha
+	if(drawData.stencilFill) {
+		// nanovg always passes the bounds of its path cache. Without them the cover quad
+		// spans the fill vertices, only they can set the stencil
+		float fillBounds[4] = {1e6f, 1e6f, -1e6f, -1e6f};
+		if(!bounds) {
+			for(auto& path : paths) {
+				for(auto i = 0; i < path.nfill; ++i) {
+					auto& vertex = path.fill[i];
+					fillBounds[0] = std::min(fillBounds[0], vertex.x);
+					fillBounds[1] = std::min(fillBounds[1], vertex.y);
+					fillBounds[2] = std::max(fillBounds[2], vertex.x);
+					fillBounds[3] = std::max(fillBounds[3], vertex.y);
+				}
+			}
+
+			bounds = fillBounds;
+		}
+
+		drawData.coverOffset = vertexCount();
+		NVGvertex cover[] = {
+			{bounds[2], bounds[3], 0.5f, 1.f},
+			{bounds[2], bounds[1], 0.5f, 1.f},
+			{bounds[0], bounds[3], 0.5f, 1.f},
+			{bounds[0], bounds[1], 0.5f, 1.f}};
+		addVertices(cover, 4);
+	}
+
+	// fills captured into an operation are counted every time it is drawn
+	auto& convexFills = operation_ ? operation_->convexFills_ : stats_.convexFills;
+	auto& stencilFills = operation_ ? operation_->stencilFills_ : stats_.stencilFills;
+	++(drawData.stencilFill ? stencilFills : convexFills);
+
+	mergeDraw();
 }
 void Renderer::stroke(const NVGpaint& paint, const NVGscissor& scissor, float fringe,
 	float strokeWidth, nytl::Span<const NVGpath> paths)
 {
 	auto& drawData = parsePaint(paint, scissor, fringe, strokeWidth);
+	drawData.kind = drawStroke;
 	drawData.paths.reserve(paths.size());
 
 	for(auto& path : paths)
 	{
 		drawData.paths.emplace_back();
-		drawData.paths.back().strokeOffset = vertices_.size();
+		drawData.paths.back().strokeOffset = vertexCount();
 		drawData.paths.back().strokeCount = path.nstroke;
-		vertices_.insert(vertices_.end(), path.stroke, path.stroke + path.nstroke);
+		addVertices(path.stroke, path.nstroke);
 	}
+
+	mergeDraw();
 }
 void Renderer::triangles(const NVGpaint& paint, const NVGscissor& scissor,
 	nytl::Span<const NVGvertex> verts)
 {
 	auto& drawData = parsePaint(paint, scissor, 1.f, 1.f);
+	drawData.kind = drawTriangles;
 
-	drawData.triangleOffset = vertices_.size();
+	drawData.triangleOffset = vertexCount();
 	drawData.triangleCount = verts.size();
-	vertices_.insert(vertices_.end(), verts.begin(), verts.end());
+	addVertices(verts.data(), verts.size());
+
+	mergeDraw();
 }
 
-DrawData& Renderer::parsePaint(const NVGpaint& paint, const NVGscissor& scissor, float fringe,
-	float strokeWidth)
+void Renderer::addVertices(const NVGvertex* vertices, std::size_t count)
+{
+	auto offset = vertices_.size();
+	vertices_.resize(offset + count * vertexStride_);
+	if(!settings_.packedVertices) {
+		std::memcpy(vertices_.data() + offset, vertices, count * sizeof(NVGvertex));
+		return;
+	}
+
+	// converted while copying, out of range values are clamped
+	auto scale = static_cast<float>(settings_.packedVertices);
+	auto snorm = [&](float value) {
+		auto scaled = std::round(value * scale);
+		return static_cast<std::int16_t>(std::max(std::min(scaled, 32767.f), -32767.f));
+	};
+	auto unorm = [](float value) {
+		auto scaled = std::round(value * 65535.f);
+		return static_cast<std::uint16_t>(std::max(std::min(scaled, 65535.f), 0.f));
+	};
+
+	auto packed = reinterpret_cast<PackedVertex*>(vertices_.data() + offset);
+	for(auto i = 0u; i < count; ++i) {
+		auto& vertex = vertices[i];
+		packed[i] = {snorm(vertex.x), snorm(vertex.y), unorm(vertex.u), unorm(vertex.v)};
+	}
+}
+
+void Renderer::mergeDraw()
 {
-	static constexpr auto typeColor = 1;
-	static constexpr auto typeGradient = 2;
-	static constexpr auto typeTexture = 3;
+	// draws are never merged into draws outside of the captured operation
+	if(drawDatas_.size() < operationDrawStart_ + 2)
+		return;
+
+	auto& prev = drawDatas_[drawDatas_.size() - 2];
+	auto& data = drawDatas_.back();
+	if(prev.operation)
+		return;
 
-	static constexpr auto texTypeRGBA = 1;
-	static constexpr auto texTypeA = 2;
+	// merging stencil fills would combine their winding numbers
+	if(prev.stencilFill || data.stencilFill)
+		return;
+
+	// measured draws keep their kind
+	if(settings_.gpuTimings && prev.kind != data.kind)
+		return;
 
+	// the draws must use exactly the same state. With the texture array the texture is
+	// selected by the slot in texType, so no descriptor set has to match
+	if(!settings_.textureArraySize && prev.texture != data.texture)
+		return;
+
+	if(std::memcmp(&prev.uniformData, &data.uniformData, sizeof(UniformData)) != 0)
+		return;
+
+	// record draws the paths before the triangles, so the draw order is only kept if
+	// the previous draw has no triangles or the triangles directly follow them
+	if(prev.triangleCount > 0) {
+		if(!data.paths.empty()) return;
+		if(prev.triangleOffset + prev.triangleCount != data.triangleOffset) return;
+	}
+
+	prev.paths.insert(prev.paths.end(), data.paths.begin(), data.paths.end());
+	if(data.triangleCount > 0) {
+		if(prev.triangleCount == 0) prev.triangleOffset = data.triangleOffset;
+		prev.triangleCount += data.triangleCount;
+	}
+
+	drawDatas_.pop_back();
+	++stats_.mergedDraws;
+}
+
+DrawData& Renderer::parsePaint(const NVGpaint& paint, const NVGscissor& scissor, float fringe,
+	float strokeWidth)
+{
 	//update image
 	drawDatas_.emplace_back();
 
 	auto& data = drawDatas_.back();
 	data.uniformData.viewSize = {float(width_), float(height_)};
 
-	if(paint.image) {
-		auto* tex = texture(paint.image);
+	// stale or invalid handles are drawn like an untextured paint
+	auto* tex = paint.image ? texture(paint.image) : nullptr;
+	if(paint.image && !tex)
+		dlg_warn("vvg::Renderer::parsePaint: invalid texture handle {}", paint.image);
 
+	if(tex) {
 		auto formatID = (tex->format() == vk::Format::r8g8b8a8Unorm) ? texTypeRGBA : texTypeA;
+		if(tex->premultiplied()) formatID = texTypePremultiplied;
 		data.uniformData.type = typeTexture;
 		data.uniformData.texType = formatID;
 
+		// the upper bits of texType contain the slot in the texture array
+		if(settings_.textureArraySize)
+			data.uniformData.texType |= ((paint.image & textureIndexMask) - 1) << 8;
+
 		data.texture = paint.image;
 	} else if(std::memcmp(&paint.innerColor, &paint.outerColor, sizeof(paint.innerColor)) == 0) {
 		data.uniformData.type = typeColor;
@@ -629,6 +2511,12 @@ DrawData& Renderer::parsePaint(const NVGpaint& paint, const NVGscissor& scissor,
 
 	std::memcpy(&data.uniformData.scissorMat, &scissorMat, sizeof(scissorMat));
 
+	// the cheapest pipeline variant that can draw the paint
+	// draws without scissor skip the scissor mask, textures their format selection
+	data.variant = data.uniformData.type | ((data.uniformData.texType & 0xFFu) << 2);
+	if(scissor.extent[0] >= -0.5f && scissor.extent[1] >= -0.5f)
+		data.variant |= variantScissor;
+
 	//paint
 	float paintMat[4][4] {};
 	nvgTransformInverse(invxform, paint.xform);
@@ -646,130 +2534,725 @@ DrawData& Renderer::parsePaint(const NVGpaint& paint, const NVGscissor& scissor,
 	//strokeMult
 	paintMat[0][3] = (strokeWidth * 0.5f + fringe * 0.5f) / fringe;
 
+	//transform scale (translation is 0), only changed for operations
+	paintMat[1][3] = 1.f;
+	paintMat[2][3] = 1.f;
+
 	std::memcpy(&data.uniformData.paintMat, &paintMat, sizeof(paintMat));
 	return data;
 }
 
-const Texture* Renderer::texture(unsigned int id) const
+const vpp::RenderPass& Renderer::renderPass() const
 {
-	auto it = std::find_if(textures_.begin(), textures_.end(),
-		[=](const auto& tex) { return tex.id() == id; });
+	static const vpp::RenderPass none;
+	return renderPass_ ? *renderPass_ : none;
+}
 
-	if(it == textures_.end()) return nullptr;
-	return &(*it);
+const Texture* Renderer::texture(unsigned int id) const
+{
+	return shared_->texture(id);
 }
 
 Texture* Renderer::texture(unsigned int id)
 {
-	auto it = std::find_if(textures_.begin(), textures_.end(),
-		[=](const auto& tex) { return tex.id() == id; });
-
-	if(it == textures_.end()) return nullptr;
-	return &(*it);
+	return shared_->texture(id);
 }
 
 void Renderer::record(vk::CommandBuffer cmdBuffer)
 {
-	int bound = 0;
-	vk::cmdBindVertexBuffers(cmdBuffer, 0, {vertexBuffer_}, {0});
+	RecordState state;
+	recordRange(cmdBuffer, 0, drawDatas_.size(), state);
+	addRecordStats(stats_, state);
+}
 
-	for(auto& data : drawDatas_)
-	{
-		vk::cmdBindDescriptorSets(cmdBuffer, vk::PipelineBindPoint::graphics, pipelineLayout_,
-			0, {data.descriptorSet}, {});
+void Renderer::recordTimed(vk::CommandBuffer cmdBuffer, std::vector<std::uint8_t>& groups)
+{
+	// swapchain frames are recorded inside the render pass, so only the draws are measured
+	auto& frame = frames_[frameIndex_];
+	auto writeTimestamp = [&](unsigned int query) {
+		vk::cmdWriteTimestamp(cmdBuffer, vk::PipelineStageBits::bottomOfPipe,
+			frame.timestampPool, query);
+	};
 
-		for(auto& path : data.paths) {
-			if(path.fillCount > 0) {
-				if(bound != 1) {
-					vk::cmdBindPipeline(cmdBuffer, vk::PipelineBindPoint::graphics, fanPipeline_);
-					bound = 1;
-				}
+	RecordState state;
+	state.timestamps = frame.timestampPool;
 
-				vk::cmdDraw(cmdBuffer, path.fillCount, 1, path.fillOffset, 0);
-			} if(path.strokeCount > 0) {
-				if(bound != 2) {
-					vk::cmdBindPipeline(cmdBuffer, vk::PipelineBindPoint::graphics, stripPipeline_);
-					bound = 2;
-				}
+	writeTimestamp(queryFrameStart);
+	recordRange(cmdBuffer, 0, drawDatas_.size(), state);
+	writeTimestamp(queryDrawsEnd);
+	writeTimestamp(queryFrameEnd);
 
-				vk::cmdDraw(cmdBuffer, path.strokeCount, 1, path.strokeOffset, 0);
+	addRecordStats(stats_, state);
+	groups = std::move(state.groups);
+}
+
+void Renderer::recordRange(vk::CommandBuffer cmdBuffer, std::size_t begin, std::size_t end,
+	RecordState& state)
+{
+	vk::PipelineLayout layout = shared_->pipelineLayout_;
+	auto& frame = frames_[frameIndex_];
+	auto indexed = settings_.indexedGeometry;
+
+	// with indexed geometry everything is drawn with triangle list pipelines
+	auto bindBuffers = [&]{
+		if(!vertices_.empty())
+			vk::cmdBindVertexBuffers(cmdBuffer, 0, {frame.vertexBuffer}, {0});
+		if(indexed && !indices_.empty())
+			vk::cmdBindIndexBuffer(cmdBuffer, frame.indexBuffer, 0, frame.indexType);
+	};
+
+	bindBuffers();
+	if(settings_.pushConstants) {
+		vk::cmdBindDescriptorSets(cmdBuffer, vk::PipelineBindPoint::graphics, layout,
+			0, {frame.uniformSet}, {0});
+		++state.descriptorBinds;
+	}
+
+	// the texture array is bound once, the texture is selected using the uniform data
+	if(settings_.textureArraySize) {
+		vk::cmdBindDescriptorSets(cmdBuffer, vk::PipelineBindPoint::graphics, layout,
+			1, {frame.textureArraySet}, {});
+		++state.descriptorBinds;
+		state.textureBound = true;
+	}
+
+	for(auto i = begin; i < end; ++i)
+	{
+		auto& data = drawDatas_[i];
+		if(!data.operation) {
+			recordDraw(cmdBuffer, data, data.uniformData, frame.uniformSet, data.uniformOffset,
+				state);
+			continue;
+		}
+
+		// operations use their own buffers and their uniform slots for the current frame.
+		// Buffers are only created for captured geometry, without it nothing is drawn
+		auto& operation = *data.operation;
+		if(!operation.vertexBuffer_.vkHandle() || (indexed && !operation.indexBuffer_.vkHandle()))
+			continue;
+
+		vk::cmdBindVertexBuffers(cmdBuffer, 0, {operation.vertexBuffer_}, {0});
+		if(indexed)
+			vk::cmdBindIndexBuffer(cmdBuffer, operation.indexBuffer_, 0, vk::IndexType::uint32);
+
+		auto stride = uniformStride(device());
+		auto slot = frameIndex_ * operation.draws_.size();
+		Vec2 viewSize = {float(width_), float(height_)};
+		for(auto i = 0u; i < operation.draws_.size(); ++i) {
+			auto& draw = operation.draws_[i];
+			auto offset = static_cast<std::uint32_t>((slot + i) * stride);
+			if(settings_.pushConstants) {
+				auto uniformData = operationUniformData(operation, draw, viewSize);
+				recordDraw(cmdBuffer, draw, uniformData, operation.uniformSet_, offset, state);
+			} else {
+				recordDraw(cmdBuffer, draw, draw.uniformData, operation.uniformSet_, offset,
+					state);
 			}
 		}
 
-		if(data.triangleCount > 0) {
-			if(bound != 3) {
-				vk::cmdBindPipeline(cmdBuffer, vk::PipelineBindPoint::graphics, listPipeline_);
-				bound = 3;
+		bindBuffers();
+	}
+}
+
+void Renderer::recordParallel(RenderFrame& frame, std::size_t chunks)
+{
+	// command buffers from one pool must not be recorded at the same time
+	while(frame.recordBuffers.size() < chunks) {
+		frame.recordPools.emplace_back(device(), renderQueue_->family(),
+			vk::CommandPoolCreateBits::resetCommandBuffer);
+		frame.recordBuffers.push_back(
+			frame.recordPools.back().allocate(vk::CommandBufferLevel::secondary));
+	}
+
+	// the recording threads must only look up pipelines
+	shared_->resolvePipelines();
+
+	vk::CommandBufferInheritanceInfo inheritance;
+	inheritance.renderPass = vkRenderPass();
+	inheritance.subpass = 0;
+	inheritance.framebuffer = *framebuffer_;
+
+	vk::CommandBufferBeginInfo beginInfo;
+	beginInfo.flags = vk::CommandBufferUsageBits::renderPassContinue;
+	beginInfo.pInheritanceInfo = &inheritance;
+
+	auto size = framebuffer_->size();
+	auto chunkSize = (drawDatas_.size() + chunks - 1) / chunks;
+	std::vector<RecordState> states(chunks);
+
+	// secondary command buffers inherit no state, everything is bound again
+	auto task = [&](unsigned int i) {
+		auto begin = std::min(i * chunkSize, drawDatas_.size());
+		auto end = std::min(begin + chunkSize, drawDatas_.size());
+		auto& cmdBuffer = frame.recordBuffers[i];
+
+		vk::beginCommandBuffer(cmdBuffer, beginInfo);
+		recordViewport(cmdBuffer, size.width, size.height);
+		recordRange(cmdBuffer, begin, end, states[i]);
+		vk::endCommandBuffer(cmdBuffer);
+	};
+
+	auto count = static_cast<unsigned int>(chunks);
+	if(settings_.executor) {
+		settings_.executor(count, task);
+	} else {
+		std::vector<std::future<void>> futures;
+		for(auto i = 1u; i < count; ++i)
+			futures.push_back(std::async(std::launch::async, task, i));
+
+		task(0);
+		for(auto& future : futures)
+			future.get();
+	}
+
+	for(auto& state : states)
+		addRecordStats(stats_, state);
+}
+
+void Renderer::recordDraw(vk::CommandBuffer cmdBuffer, const DrawData& data,
+	const UniformData& uniformData, vk::DescriptorSet uniformSet, std::uint32_t uniformOffset,
+	RecordState& state)
+{
+	vk::PipelineLayout layout = shared_->pipelineLayout_;
+
+	// a new group starts every time the kind of the measured draws changes
+	if(state.timestamps && state.groups.size() < maxTimestampGroups &&
+			(state.groups.empty() || state.groups.back() != data.kind)) {
+		auto query = queryFirstGroup + static_cast<unsigned int>(state.groups.size());
+		vk::cmdWriteTimestamp(cmdBuffer, vk::PipelineStageBits::bottomOfPipe,
+			state.timestamps, query);
+		state.groups.push_back(data.kind);
+	}
+
+	// consecutive draws with the same paint variant keep the pipeline bound
+	// waits only if the pipeline is still created in the background
+	auto bind = [&](PipelineType type) {
+		auto key = pipelineKey(type, data.variant, edgeAA_, blendAlpha_);
+		if(state.pipeline != key) {
+			auto pipeline = shared_->pipeline(vkRenderPass(), key);
+			vk::cmdBindPipeline(cmdBuffer, vk::PipelineBindPoint::graphics, pipeline);
+			state.pipeline = key;
+			++state.pipelineBinds;
+		}
+	};
+
+	if(settings_.pushConstants) {
+		auto pushed = pushData(uniformData);
+		auto stages = vk::ShaderStageBits::vertex | vk::ShaderStageBits::fragment;
+		vk::cmdPushConstants(cmdBuffer, layout, stages, 0, sizeof(pushed), &pushed);
+	} else {
+		vk::cmdBindDescriptorSets(cmdBuffer, vk::PipelineBindPoint::graphics,
+			layout, 0, {uniformSet}, {uniformOffset});
+		++state.descriptorBinds;
+	}
+
+	// texture descriptors only have to be rebound when the texture changes
+	if(!state.textureBound || (state.texture != data.texture && !settings_.textureArraySize)) {
+		vk::cmdBindDescriptorSets(cmdBuffer, vk::PipelineBindPoint::graphics,
+			layout, 1, {textureDescriptorSet(data.texture)}, {});
+		++state.descriptorBinds;
+		state.texture = data.texture;
+		state.textureBound = true;
+	}
+
+	// every draw command is counted for the stats
+	auto draw = [&](std::uint32_t count, std::uint32_t first) {
+		vk::cmdDraw(cmdBuffer, count, 1, first, 0);
+		++state.drawCommands;
+	};
+
+	auto drawIndexed = [&](std::uint32_t count, std::uint32_t first) {
+		vk::cmdDrawIndexed(cmdBuffer, count, 1, first, 0, 0);
+		++state.drawCommands;
+	};
+
+	auto indexed = settings_.indexedGeometry;
+	if(indexed && data.stencilFill) {
+		auto offset = data.indexOffset;
+		bind(pipelineFillStencil);
+		drawIndexed(data.stencilIndexCount, offset);
+		offset += data.stencilIndexCount;
+
+		if(data.fringeIndexCount > 0) {
+			bind(pipelineFillFringe);
+			drawIndexed(data.fringeIndexCount, offset);
+			offset += data.fringeIndexCount;
+		}
+
+		bind(pipelineFillCover);
+		drawIndexed(data.indexOffset + data.indexCount - offset, offset);
+		return;
+	} else if(indexed) {
+		if(data.indexCount > 0) {
+			bind(pipelineList);
+			drawIndexed(data.indexCount, data.indexOffset);
+		}
+
+		return;
+	}
+
+	if(data.stencilFill) {
+		bind(pipelineFillStencil);
+		for(auto& path : data.paths)
+			if(path.fillCount > 0)
+				draw(path.fillCount, path.fillOffset);
+
+		for(auto& path : data.paths) {
+			if(path.strokeCount > 0) {
+				bind(pipelineFillFringe);
+				draw(path.strokeCount, path.strokeOffset);
 			}
+		}
+
+		bind(pipelineFillCover);
+		draw(4, data.coverOffset);
+		return;
+	}
 
-			vk::cmdDraw(cmdBuffer, data.triangleCount, 1, data.triangleOffset, 0);
+	for(auto& path : data.paths) {
+		if(path.fillCount > 0) {
+			bind(pipelineFan);
+			draw(path.fillCount, path.fillOffset);
+		} if(path.strokeCount > 0) {
+			bind(pipelineStrip);
+			draw(path.strokeCount, path.strokeOffset);
 		}
 	}
+
+	if(data.triangleCount > 0) {
+		bind(pipelineList);
+		draw(data.triangleCount, data.triangleOffset);
+	}
 }
 
-void Renderer::initRenderPass(const vpp::Device& dev, vk::Format attachment)
+
+//OffscreenRenderer
+OffscreenTarget::OffscreenTarget(const vpp::Device& dev, const vk::Extent2D& size,
+	vk::Format format, vk::SampleCountBits samples)
+		: targetRenderPass_(createRenderPass(dev, format, samples,
+			vk::ImageLayout::transferSrcOptimal))
 {
-	vk::AttachmentDescription attachments[2] {};
+	auto colorInfo = vpp::ViewableImage::defaultColor2D();
+	colorInfo.imgInfo.format = format;
+	colorInfo.viewInfo.format = format;
+	colorInfo.imgInfo.usage = vk::ImageUsageBits::colorAttachment |
+		vk::ImageUsageBits::transferSrc;
+
+	auto stencilInfo = vpp::ViewableImage::defaultDepth2D();
+	stencilInfo.imgInfo.format = vk::Format::s8Uint;
+	stencilInfo.viewInfo.format = vk::Format::s8Uint;
+	stencilInfo.viewInfo.subresourceRange.aspectMask = vk::ImageAspectBits::stencil;
+	stencilInfo.imgInfo.samples = samples;
+
+	// with multisampling the image is only the resolve target
+	std::vector<vpp::ViewableImage::CreateInfo> attachments {colorInfo, stencilInfo};
+	if(samples != vk::SampleCountBits::e1) {
+		auto multisampleInfo = colorInfo;
+		multisampleInfo.imgInfo.samples = samples;
+		multisampleInfo.imgInfo.usage = vk::ImageUsageBits::colorAttachment |
+			vk::ImageUsageBits::transientAttachment;
+		attachments.push_back(multisampleInfo);
+	}
 
-	//color from swapchain
-	attachments[0].format = attachment;
-	attachments[0].samples = vk::SampleCountBits::e1;
-	attachments[0].loadOp = vk::AttachmentLoadOp::clear;
-	attachments[0].storeOp = vk::AttachmentStoreOp::store;
-	attachments[0].stencilLoadOp = vk::AttachmentLoadOp::dontCare;
-	attachments[0].stencilStoreOp = vk::AttachmentStoreOp::dontCare;
-	attachments[0].initialLayout = vk::ImageLayout::undefined;
-	attachments[0].finalLayout = vk::ImageLayout::presentSrcKHR;
+	targetFramebuffer_ = {dev, targetRenderPass_, size, attachments};
+}
 
-	vk::AttachmentReference colorReference;
-	colorReference.attachment = 0;
-	colorReference.layout = vk::ImageLayout::colorAttachmentOptimal;
+// The sample count the renderer will use, the one of the shared resources if given.
+vk::SampleCountBits offscreenSampleCount(const RendererSettings& settings)
+{
+	auto& shared = settings.sharedResources;
+	return shared ? shared->settings().sampleCount : settings.sampleCount;
+}
 
-	//stencil attachment
-	//will not be used as depth buffer
-	attachments[1].format = vk::Format::s8Uint;
-	attachments[1].samples = vk::SampleCountBits::e1;
-	attachments[1].loadOp = vk::AttachmentLoadOp::clear;
-	attachments[1].storeOp = vk::AttachmentStoreOp::store;
-	attachments[1].stencilLoadOp = vk::AttachmentLoadOp::dontCare;
-	attachments[1].stencilStoreOp = vk::AttachmentStoreOp::dontCare;
-	attachments[1].initialLayout = vk::ImageLayout::undefined;
-	attachments[1].finalLayout = vk::ImageLayout::depthStencilAttachmentOptimal;
-	// attachments[1].initialLayout = vk::ImageLayout::depthStencilAttachmentOptimal;
-	// attachments[1].finalLayout = vk::ImageLayout::depthStencilAttachmentOptimal;
+OffscreenRenderer::OffscreenRenderer(const vpp::Device& dev, const vk::Extent2D& size,
+	vk::Format format, const RendererSettings& settings)
+		: OffscreenTarget(dev, size, format, offscreenSampleCount(settings)),
+		Renderer(targetFramebuffer_, targetRenderPass_, settings),
+		size_(size), format_(format)
+{
+	if(formatSize(format) != 4)
+		throw std::invalid_argument("vvg::OffscreenRenderer: format must have 4 byte pixels");
 
-	vk::AttachmentReference depthReference;
-	depthReference.attachment = 1;
-	depthReference.layout = vk::ImageLayout::depthStencilAttachmentOptimal;
+	vk::BufferCreateInfo bufInfo;
+	bufInfo.usage = vk::BufferUsageBits::transferDst;
+	bufInfo.size = size.width * size.height * 4;
 
-	//only subpass
-	vk::SubpassDescription subpass;
-	subpass.pipelineBindPoint = vk::PipelineBindPoint::graphics;
-	subpass.flags = {};
-	subpass.inputAttachmentCount = 0;
-	subpass.pInputAttachments = nullptr;
-	subpass.colorAttachmentCount = 1;
-	subpass.pColorAttachments = &colorReference;
-	subpass.pResolveAttachments = nullptr;
-	subpass.pDepthStencilAttachment = &depthReference;
-	subpass.preserveAttachmentCount = 0;
-	subpass.pPreserveAttachments = nullptr;
+	auto bits = device().memoryTypeBits(vk::MemoryPropertyBits::hostVisible);
+	readbacks_.resize(frames_.size());
+	for(auto& readback : readbacks_)
+		readback.buffer = {device(), bufInfo, bits};
+}
 
-	vk::RenderPassCreateInfo renderPassInfo;
-	renderPassInfo.attachmentCount = 2;
-	renderPassInfo.pAttachments = attachments;
-	renderPassInfo.subpassCount = 1;
-	renderPassInfo.pSubpasses = &subpass;
-	renderPassInfo.dependencyCount = 0;
-	renderPassInfo.pDependencies = nullptr;
+OffscreenRenderer::~OffscreenRenderer()
+{
+	// the Renderer destructor can no longer deliver the frames
+	wait();
+}
+
+std::future<OffscreenImage> OffscreenRenderer::nextFrame()
+{
+	requests_.emplace_back();
+	return requests_.back().get_future();
+}
+
+const vpp::ViewableImage& OffscreenRenderer::image() const
+{
+	return targetFramebuffer_.attachments()[0];
+}
+
+void OffscreenRenderer::recordAfterRenderPass(vk::CommandBuffer cmdBuffer, unsigned int frame)
+{
+	// the render pass leaves the image in the transferSrcOptimal layout, its dependencies
+	// order the copy after the rendering and the next frame after the copy
+	vk::BufferImageCopy copy;
+	copy.imageSubresource = {vk::ImageAspectBits::color, 0, 0, 1};
+	copy.imageExtent = {size_.width, size_.height, 1};
+	vk::cmdCopyImageToBuffer(cmdBuffer, image().vkImage(), vk::ImageLayout::transferSrcOptimal,
+		readbacks_[frame].buffer, {copy});
+
+	vk::MemoryBarrier barrier;
+	barrier.srcAccessMask = vk::AccessBits::transferWrite;
+	barrier.dstAccessMask = vk::AccessBits::hostRead;
+	vk::cmdPipelineBarrier(cmdBuffer, vk::PipelineStageBits::transfer,
+		vk::PipelineStageBits::host, {}, {barrier}, {}, {});
+}
+
+void OffscreenRenderer::frameSubmitted(unsigned int frame)
+{
+	auto& readback = readbacks_[frame];
+	readback.frame = frameCount_;
+	readback.promises = std::move(requests_);
+	requests_.clear();
+}
+
+void OffscreenRenderer::frameFinished(unsigned int frame)
+{
+	auto& readback = readbacks_[frame];
+	if(!readback.frame)
+		return;
+
+	OffscreenImage image;
+	image.frame = readback.frame;
+	image.size = size_;
+	image.format = format_;
+	image.data.resize(size_.width * size_.height * 4);
+
+	auto map = readback.buffer.memoryMap();
+	if(!map.coherent()) map.invalidate();
+	std::memcpy(image.data.data(), map.ptr(), image.data.size());
+	readback.frame = 0;
+
+	if(callback_)
+		callback_(image);
+
+	auto promises = std::move(readback.promises);
+	readback.promises.clear();
+	for(auto& promise : promises)
+		promise.set_value(image);
+}
+
+
+//BatchRenderer
+BatchRenderer::BatchRenderer(const vpp::Device& dev, const BatchSettings& settings)
+	: device_(dev), settings_(settings)
+{
+	auto count = settings.threads;
+	if(!count) count = std::max(std::thread::hardware_concurrency(), 1u);
+
+	if(!settings.jobsInFlight || !settings.renderersPerThread)
+		throw std::invalid_argument("vvg::BatchRenderer: invalid settings");
+
+	// every job must be submitted, an elided frame would never be read back
+	settings_.renderer.framesInFlight = settings.jobsInFlight;
+	settings_.renderer.elideIdenticalFrames = false;
+
+	// renderers sharing resources must be used from the same thread, so every worker
+	// gets its own. They are created here so that errors are thrown to the caller
+	for(auto i = 0u; i < count; ++i)
+		shared_.push_back(std::make_shared<SharedResources>(dev, settings_.renderer));
+
+	for(auto& resources : shared_)
+		threads_.emplace_back(&BatchRenderer::work, this, resources);
+}
+
+BatchRenderer::~BatchRenderer()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		exit_ = true;
+	}
+
+	jobsCondition_.notify_all();
+	for(auto& thread : threads_)
+		thread.join();
+
+	// the workers are joined, so their resources can be used here.
+	// Only the first one stores the pipeline cache, merged with the ones of the others,
+	// since they would all write the same file
+	auto& first = *shared_.front();
+	if(first.pipelineCachePath_.empty())
+		return;
+
+	// pipelines still created in the background use the caches
+	first.resolvePipelines();
+	std::vector<vk::PipelineCache> caches;
+	for(auto i = 1u; i < shared_.size(); ++i) {
+		shared_[i]->resolvePipelines();
+		shared_[i]->pipelineCachePath_.clear();
+		caches.push_back(shared_[i]->pipelineCache_);
+	}
+
+	if(!caches.empty())
+		vk::mergePipelineCaches(device_, first.pipelineCache_, caches);
+}
+
+std::future<OffscreenImage> BatchRenderer::add(const vk::Extent2D& size, Scene scene)
+{
+	if(!size.width || !size.height || !scene)
+		throw std::invalid_argument("vvg::BatchRenderer::add: invalid job");
+
+	Job job {size, std::move(scene), {}};
+	auto future = job.promise.get_future();
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		jobs_.push_back(std::move(job));
+		++pending_;
+	}
+
+	jobsCondition_.notify_one();
+	return future;
+}
+
+void BatchRenderer::wait()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	idleCondition_.wait(lock, [&]{ return pending_ == 0; });
+}
+
+void BatchRenderer::finished()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		--pending_;
+	}
+
+	idleCondition_.notify_all();
+}
+
+void BatchRenderer::work(std::shared_ptr<SharedResources> shared)
+{
+	// a renderer per target size, the most recently used first.
+	// The promises of the submitted jobs are fulfilled in order by the readback callback
+	struct Target {
+		OffscreenRenderer* renderer;
+		NVGcontext* context;
+		std::deque<std::promise<OffscreenImage>> promises;
+	};
+
+	// Waiting for frames submits pending work through the submit manager of the device
+	// and renderers create and destroy queue resources, so all of this is done with the
+	// submit mutex held. Device memory is allocated from the allocator vpp keeps for
+	// every thread, so scenes may create textures without it.
+	std::list<Target> targets;
+	auto settings = settings_.renderer;
+	settings.sharedResources = std::move(shared);
+
+	auto destroy = [&](Target& target) {
+		std::lock_guard<std::mutex> submitLock(submitMutex_);
+		target.renderer->wait();
+		destroyContext(*target.context);
+	};
+
+	auto acquire = [&](const vk::Extent2D& size) -> Target& {
+		auto it = std::find_if(targets.begin(), targets.end(), [&](const Target& target) {
+			auto& current = target.renderer->size();
+			return current.width == size.width && current.height == size.height;
+		});
+
+		if(it != targets.end()) {
+			targets.splice(targets.begin(), targets, it);
+			return targets.front();
+		}
+
+		if(targets.size() >= settings_.renderersPerThread) {
+			destroy(targets.back());
+			targets.pop_back();
+		}
+
+		std::unique_lock<std::mutex> submitLock(submitMutex_);
+		auto renderer = std::make_unique<OffscreenRenderer>(device_, size, settings_.format,
+			settings);
+		targets.push_front({renderer.get(), nullptr, {}});
+		auto& target = targets.front();
+
+		// list elements are not moved, so the target can be referenced
+		renderer->onFrame([this, promises = &target.promises](const OffscreenImage& image) {
+			promises->front().set_value(image);
+			promises->pop_front();
+			finished();
+		});
+
+		// the contexts share the font atlas, it only has to be initialized if there
+		// is no other context
+		try {
+			target.context = createContext(std::move(renderer));
+			submitLock.unlock();
+			if(settings_.contextInit && targets.size() == 1)
+				settings_.contextInit(*target.context);
+		} catch(...) {
+			if(!submitLock.owns_lock()) submitLock.lock();
+			if(target.context) destroyContext(*target.context);
+			targets.pop_front();
+			throw;
+		}
+
+		return target;
+	};
+
+	while(true) {
+		std::unique_lock<std::mutex> lock(mutex_);
+		if(jobs_.empty()) {
+			// deliver the pending frames before waiting for new jobs
+			lock.unlock();
+			{
+				std::lock_guard<std::mutex> submitLock(submitMutex_);
+				for(auto& target : targets)
+					target.renderer->wait();
+			}
+
+			lock.lock();
+			jobsCondition_.wait(lock, [&]{ return exit_ || !jobs_.empty(); });
+			if(jobs_.empty())
+				break;
+		}
+
+		auto job = std::move(jobs_.front());
+		jobs_.pop_front();
+		lock.unlock();
+
+		Target* current {};
+		try {
+			current = &acquire(job.size);
+			nvgBeginFrame(current->context, job.size.width, job.size.height, 1.f);
+			job.scene(*current->context);
+		} catch(...) {
+			if(current) nvgCancelFrame(current->context);
+			job.promise.set_exception(std::current_exception());
+			finished();
+			continue;
+		}
+
+		current->promises.push_back(std::move(job.promise));
+		try {
+			std::lock_guard<std::mutex> submitLock(submitMutex_);
+			nvgEndFrame(current->context);
+		} catch(...) {
+			// the frame was not submitted, so the promise was not fulfilled
+			current->promises.back().set_exception(std::current_exception());
+			current->promises.pop_back();
+			finished();
+		}
+	}
+
+	for(auto& target : targets)
+		destroy(target);
+}
+
+
+//Layer
+// Renderer of a layer, clears to transparent and accumulates the coverage in the alpha
+// channel. The dependencies of the render pass make the contents visible to the shaders
+// of later submissions.
+struct LayerRenderer : public Renderer {
+	LayerRenderer(const vpp::Framebuffer& fb, vk::RenderPass rp, const RendererSettings& settings)
+		: Renderer(fb, rp, settings)
+	{
+		clearColor_ = {{0.f, 0.f, 0.f, 0.f}};
+		blendAlpha_ = true;
+	}
+};
+
+Layer::Layer(Renderer& renderer, const vk::Extent2D& size, const RendererSettings& settings)
+	: size_(size)
+{
+	auto& dev = renderer.device();
+	auto samples = renderer.settings().sampleCount;
+	constexpr auto format = vk::Format::r8g8b8a8Unorm;
+
+	if(!size.width || !size.height)
+		throw std::invalid_argument("vvg::Layer: invalid size");
+
+	image_ = renderer.createTexture(format, size.width, size.height, nullptr,
+		vk::ImageUsageBits::colorAttachment);
+	if(!image_)
+		throw std::runtime_error("vvg::Layer: could not create the texture");
+
+	// blending into the transparent texture leaves premultiplied colors
+	renderer.texture(image_)->premultiplied_ = true;
+
+	// the texture is the color attachment 0, the stencil and multisampled color
+	// attachments are owned by the framebuffer
+	renderPass_ = createRenderPass(dev, format, samples, vk::ImageLayout::shaderReadOnlyOptimal);
+
+	auto stencilInfo = vpp::ViewableImage::defaultDepth2D();
+	stencilInfo.imgInfo.format = vk::Format::s8Uint;
+	stencilInfo.viewInfo.format = vk::Format::s8Uint;
+	stencilInfo.viewInfo.subresourceRange.aspectMask = vk::ImageAspectBits::stencil;
+	stencilInfo.imgInfo.samples = samples;
+
+	std::vector<vpp::ViewableImage::CreateInfo> attachments {stencilInfo};
+	if(samples != vk::SampleCountBits::e1) {
+		auto multisampleInfo = vpp::ViewableImage::defaultColor2D();
+		multisampleInfo.imgInfo.format = format;
+		multisampleInfo.viewInfo.format = format;
+		multisampleInfo.imgInfo.samples = samples;
+		multisampleInfo.imgInfo.usage = vk::ImageUsageBits::colorAttachment |
+			vk::ImageUsageBits::transientAttachment;
+		attachments.push_back(multisampleInfo);
+	}
+
+	auto view = renderer.texture(image_)->viewableImage().vkImageView();
+	framebuffer_ = {dev, renderPass_, size, attachments, {{0, view}}};
+
+	auto layerSettings = settings;
+	layerSettings.sharedResources = renderer.sharedResources();
+
+	try {
+		context_ = createContext(std::make_unique<LayerRenderer>(framebuffer_, renderPass_,
+			layerSettings));
+	} catch(...) {
+		renderer.deleteTexture(image_);
+		throw;
+	}
+}
+
+Layer::~Layer()
+{
+	// other renderers may still sample the texture, it is destroyed with their frames
+	auto& renderer = getRenderer(*context_);
+	renderer.wait();
+	renderer.deleteTexture(image_);
+	destroyContext(*context_);
+}
+
+NVGcontext& Layer::begin()
+{
+	nvgBeginFrame(context_, size_.width, size_.height, 1.f);
+	return *context_;
+}
 
-	renderPass_ = {dev, renderPassInfo};
+void Layer::end()
+{
+	nvgEndFrame(context_);
+	getRenderer(*context_).sharedResources()->textureChanged(image_);
+	dirty_ = false;
 }
 
 
 //Texture
 Texture::Texture(const vpp::Device& dev, unsigned int xid, const vk::Extent2D& size,
-	vk::Format format, const std::uint8_t* data)
+	vk::Format format, const std::uint8_t* data, bool initLayout, vk::ImageUsageFlags usage)
 		: format_(format), id_(xid), width_(size.width), height_(size.height)
 {
 	vk::Extent3D extent {width(), height(), 1};
@@ -777,62 +3260,105 @@ Texture::Texture(const vpp::Device& dev, unsigned int xid, const vk::Extent2D& s
 	auto info = vpp::ViewableImage::defaultColor2D();
 	info.imgInfo.extent = extent;
 	info.imgInfo.initialLayout = vk::ImageLayout::undefined;
-	info.imgInfo.tiling = vk::ImageTiling::linear;
 
 	info.imgInfo.format = format;
 	info.viewInfo.format = format;
+	info.imgInfo.usage = vk::ImageUsageBits::transferDst | vk::ImageUsageBits::sampled |
+		usage;
+
+	// textures are device local with optimal tiling and are only written by copies from
+	// staging buffers. Formats that cannot be sampled with optimal tiling fall back to
+	// host visible linear images.
+	auto props = vk::getPhysicalDeviceFormatProperties(dev.vkPhysicalDevice(), format);
+	if(props.optimalTilingFeatures & vk::FormatFeatureBits::sampledImage) {
+		info.imgInfo.tiling = vk::ImageTiling::optimal;
+		info.memoryTypeBits = dev.memoryTypeBits(vk::MemoryPropertyBits::deviceLocal);
+		layout_ = vk::ImageLayout::shaderReadOnlyOptimal;
+	} else {
+		info.imgInfo.tiling = vk::ImageTiling::linear;
+		info.memoryTypeBits = dev.memoryTypeBits(vk::MemoryPropertyBits::hostVisible);
+		layout_ = vk::ImageLayout::general;
+	}
 
-	info.imgInfo.usage = vk::ImageUsageBits::sampled;
-	info.memoryTypeBits = dev.memoryTypeBits(vk::MemoryPropertyBits::hostVisible);
-
-	// info.imgInfo.usage = vk::ImageUsageBits::transferDst | vk::ImageUsageBits::sampled;
 	viewableImage_ = {dev, info};
+	if(!initLayout)
+		return;
 
 	vpp::changeLayout(viewableImage_.image(), vk::ImageLayout::undefined,
-		vk::ImageLayout::general, {vk::ImageAspectBits::color, 0, 1, 0, 1})->finish();
+		layout_, {vk::ImageAspectBits::color, 0, 1, 0, 1})->finish();
 
-	vk::ImageLayout layout = vk::ImageLayout::general;
 	if(data)
-		vpp::fill(viewableImage_.image(), *data, format, layout, extent,
+		vpp::fill(viewableImage_.image(), *data, format, layout_, extent,
 			{vk::ImageAspectBits::color, 0, 1})->finish();
 }
 
-void Texture::update(const vk::Offset2D& offset, const vk::Extent2D& extent,
-	const std::uint8_t& data)
-{
-	unused(offset, extent);
 
-	//TODO: really only update the given offset/extent
-	//would need an extra data copy
-	//or modify vpp::fill(Image) to also accept non tightly packed data
-	//or just fill it manually...
-	// vk::Offset3D ioffset {offset.x, offset.y, 0};
+//RenderOperation
+RenderOperation::RenderOperation() = default;
+RenderOperation::~RenderOperation() = default;
 
-	vk::Extent3D iextent {width(), height(), 1};
-	vk::ImageLayout layout = vk::ImageLayout::general;
-	fill(viewableImage_.image(), data, format(), layout, iextent,
-		{vk::ImageAspectBits::color, 0, 0})->finish();
+RenderOperation::RenderOperation(RenderOperation&&) noexcept = default;
+RenderOperation& RenderOperation::operator=(RenderOperation&&) noexcept = default;
+
+bool RenderOperation::empty() const
+{
+	return draws_.empty();
 }
 
 
 //RenderImpl
-void RenderImpl::build(unsigned int, const vpp::RenderPassInstance& ini)
+void RenderImpl::build(unsigned int id, const vpp::RenderPassInstance& ini)
 {
-	renderer->record(ini.vkCommandBuffer());
+	if(!renderer->settings().gpuTimings) {
+		renderer->record(ini.vkCommandBuffer());
+		return;
+	}
+
+	if(renderer->imageTimestampGroups_.size() <= id)
+		renderer->imageTimestampGroups_.resize(id + 1);
+	renderer->recordTimed(ini.vkCommandBuffer(), renderer->imageTimestampGroups_[id]);
 }
 
 std::vector<vk::ClearValue> RenderImpl::clearValues(unsigned int)
 {
-	// TODO
-	std::vector<vk::ClearValue> ret(1, vk::ClearValue{});
-	ret[0].color = {0.f, 0.f, 0.f, 1.0f};
-	// ret[0].depthStencil = {1.f, 0};
+	// the stencil must be cleared to 0 for stencil fills
+	// with multisampling the color attachment 2 is cleared instead of the resolve target
+	auto multisampled = (renderer->settings().sampleCount != vk::SampleCountBits::e1);
+	std::vector<vk::ClearValue> ret(multisampled ? 3 : 2, vk::ClearValue{});
+	auto& color = renderer->clearColor_;
+	ret[0].color = {color[0], color[1], color[2], color[3]};
+	ret[1].depthStencil = {1.f, 0};
+	if(multisampled) ret[2].color = ret[0].color;
 	return ret;
 }
 
 void RenderImpl::frame(unsigned int id)
 {
-	swapchainRenderer->record(id);
+	if(renderer->imageRecordHashes_.size() <= id)
+		renderer->imageRecordHashes_.resize(id + 1);
+
+	// the command buffer of the image may still be executed by the frame in flight that
+	// last submitted it. It must be finished before it is recorded or submitted again
+	auto& frames = renderer->frames_;
+	auto& imageFrames = renderer->imageFrames_;
+	if(imageFrames.size() <= id)
+		imageFrames.resize(id + 1, static_cast<unsigned int>(frames.size()));
+
+	if(imageFrames[id] < frames.size())
+		renderer->finishFrame(frames[imageFrames[id]]);
+	imageFrames[id] = renderer->frameIndex_;
+
+	if(!renderer->reuseRecording(renderer->imageRecordHashes_[id])) {
+		auto start = Clock::now();
+		swapchainRenderer->record(id);
+		renderer->stats_.recordTime += millisecondsSince(start);
+	}
+
+	// reused recordings measure the same groups as when they were recorded
+	if(renderer->settings().gpuTimings) {
+		auto& frame = renderer->frames_[renderer->frameIndex_];
+		frame.timestampGroups = renderer->imageTimestampGroups_[id];
+	}
 }
 
 //class that derives vvg::Renderer for the C implementation.
@@ -844,9 +3370,22 @@ public:
 	RendererCImpl(NonOwnedDevicePtr dev, NonOwnedSwapchainPtr swapchain)
 		: Renderer(*swapchain), dev_(std::move(dev)), swapchain_(std::move(swapchain)) {}
 
+	void resize(vk::SwapchainKHR swapchain, const vk::Extent2D& size)
+	{
+		// the renderer still references the old swapchain until it is rebuilt
+		wait();
+		auto old = std::move(swapchain_);
+		swapchain_.reset(new vpp::NonOwned<vpp::Swapchain>(*dev_, swapchain, {}, size,
+			old->format()));
+		Renderer::resize(swapchain_.get());
+	}
+
 	virtual ~RendererCImpl()
 	{
 		//first destruct the Renderer since it may depend on the device and swapchain
+		//its frames in flight have to be finished before that
+		wait();
+		detach();
 		Renderer::operator=({});
 	}
 
@@ -886,14 +3425,9 @@ int deleteTexture(void* uptr, int image)
 int updateTexture(void* uptr, int image, int x, int y, int w, int h, const unsigned char* data)
 {
 	auto& renderer = resolve(uptr);
-	auto* tex = renderer.texture(image);
-	if(!tex) return 0;
-
 	vk::Extent2D extent {(unsigned int) w, (unsigned int) h};
 	vk::Offset2D offset{x, y};
-	tex->update(offset, extent, *data);
-
-	return 1;
+	return renderer.updateTexture(image, offset, extent, data);
 }
 int getTextureSize(void* uptr, int image, int* w, int* h)
 {
@@ -943,6 +3477,11 @@ void renderDelete(void* uptr)
 	auto& renderer = resolve(uptr);
 	delete &renderer;
 }
+void tessellation(void* uptr, int done)
+{
+	auto& renderer = resolve(uptr);
+	renderer.tessellation(done);
+}
 
 const NVGparams nvgContextImpl =
 {
@@ -959,7 +3498,8 @@ const NVGparams nvgContextImpl =
 	fill,
 	stroke,
 	triangles,
-	renderDelete
+	renderDelete,
+	tessellation
 };
 
 } // anonymous util namespace
@@ -969,27 +3509,40 @@ namespace vvg {
 
 NVGcontext* createContext(std::unique_ptr<Renderer> renderer)
 {
+	// fringes are only generated if they are not replaced by multisampling
 	auto impl = nvgContextImpl;
+	impl.edgeAntiAlias = (renderer->settings().sampleCount == vk::SampleCountBits::e1);
+
+	// contexts of renderers sharing their resources also share the font atlas
+	auto& shared = *renderer->sharedResources();
+	auto fontContext = shared.contexts_.empty() ? nullptr : shared.contexts_.front();
+
 	auto rendererPtr = renderer.get();
 	impl.userPtr = renderer.release();
-	auto ret = nvgCreateInternal(&impl);
+	auto ret = nvgCreateInternalShared(&impl, fontContext);
 	if(!ret) delete rendererPtr;
+	else shared.contexts_.push_back(ret);
 	return ret;
 }
 
-NVGcontext* createContext(const vpp::Swapchain& swapchain)
+NVGcontext* createContext(const vpp::Swapchain& swapchain, const RendererSettings& settings)
 {
-	return createContext(std::make_unique<Renderer>(swapchain));
+	return createContext(std::make_unique<Renderer>(swapchain, nullptr, settings));
 }
 
-NVGcontext* createContext(const vpp::Framebuffer& fb, vk::RenderPass rp)
+NVGcontext* createContext(const vpp::Framebuffer& fb, vk::RenderPass rp,
+	const RendererSettings& settings)
 {
-	return createContext(std::make_unique<Renderer>(fb, rp));
+	return createContext(std::make_unique<Renderer>(fb, rp, settings));
 }
 
 void destroyContext(const NVGcontext& context)
 {
 	auto ctx = const_cast<NVGcontext*>(&context);
+
+	// deleting the context may destroy the shared resources
+	auto& contexts = getRenderer(*ctx).sharedResources()->contexts_;
+	contexts.erase(std::remove(contexts.begin(), contexts.end(), ctx), contexts.end());
 	nvgDeleteInternal(ctx);
 }
 
@@ -1020,7 +3573,7 @@ NVGcontext* vvgCreate(const VVGContextDescription* descr)
 		vkPhDev, vkDev, {{vkQueue, descr->queueFamily}}));
 
 	// NOTE that this constructs the swapchain with an invalid surface parameter and it
-	// can therefore not be reiszed.
+	// can therefore not be resized by vpp. vvgResize replaces it with the recreated one.
 	vvg::NonOwnedSwapchainPtr swapchain(new vpp::NonOwned<vpp::Swapchain>(*dev,
 		vkSwapchain, {}, vkExtent, vkFormat));
 
@@ -1030,6 +3583,11 @@ NVGcontext* vvgCreate(const VVGContextDescription* descr)
 
 void vvgDestroy(const NVGcontext* context)
 {
-	auto ctx = const_cast<NVGcontext*>(context);
-	nvgDeleteInternal(ctx);
+	vvg::destroyContext(*context);
+}
+
+void vvgResize(NVGcontext* context, VkSwapchainKHR swapchain, VkExtent2D size)
+{
+	auto& renderer = static_cast<vvg::RendererCImpl&>(vvg::getRenderer(*context));
+	renderer.resize((vk::SwapchainKHR)swapchain, (const vk::Extent2D&)size);
 }
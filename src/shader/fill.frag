@@ -9,10 +9,19 @@
 
 #define TEXTYPE_RGBA 1
 #define TEXTYPE_A 2
+#define TEXTYPE_PREMULT 3 //rgba with premultiplied colors, e.g. rendered layers
 
 #define strokeThr -1.0f
 
 layout(constant_id = 0) const bool edgeAntiAlias = true;
+layout(constant_id = 1) const bool pushConstants = false;
+
+//pipeline variants, allow to skip the work a draw does not need
+//0 for paintType and textureFormat selects them at runtime from the draw state
+layout(constant_id = 3) const uint paintType = 0; //TYPE_* macros
+layout(constant_id = 4) const uint textureFormat = 0; //TEXTYPE_* macros
+layout(constant_id = 5) const bool scissored = true; //whether the scissor must be applied
+layout(constant_id = 6) const bool strokeAntiAlias = true; //whether strokeMask is needed
 
 layout(location = 0) in vec2 ipos;
 layout(location = 1) in vec2 itexcoord;
@@ -28,6 +37,7 @@ layout(set = 0, binding = 0) uniform UBO
 	uint type; //8
 
 	//type of the texture (if type is TYPE_TEXTURE)
+	//the upper 24 bits hold the index into tex
 	uint texType; //12
 
 	//two colors values
@@ -44,15 +54,83 @@ layout(set = 0, binding = 0) uniform UBO
 
 	//mat3 is used as matrix
 	//mat[3][0;1] is used as extent
-	//mat[3][2;3] is FREE
+	//mat[3][2;3] is used as transform translation (vertex shader)
 	//mat[0][3] is used as strokeMult
-	//mat[1][3] is FREE
-	//mat[2][3] is FREE
+	//mat[1][3] is used as transform x scale (vertex shader)
+	//mat[2][3] is used as transform y scale (vertex shader)
 	mat4 paintMat; //112
 
 } ubo;
 
-layout(set = 0, binding = 1) uniform sampler2D tex; //for texture drawing
+layout(constant_id = 2) const uint textureCount = 1;
+layout(set = 1, binding = 0) uniform sampler2D tex[textureCount]; //for texture drawing
+
+//compact version of the ubo data, used instead of it if pushConstants is set
+layout(push_constant) uniform PushConstants
+{
+	vec4 scissorMat; //upper 2x2 part of ubo.scissorMat
+	vec4 scissorTranslateExtent; //translation, scissor extent
+	vec4 scissorScaleViewSize; //scissor scale, viewSize
+	vec4 paintMat; //upper 2x2 part of ubo.paintMat
+	vec4 paintTranslateExtent; //translation, paint extent
+	vec3 params; //radius, feather, strokeMult
+	uint typeBits; //type | (texType << 8)
+	uvec4 colors; //innerColor, outerColor as packed half floats
+	vec4 transform; //translation, scale; only used in the vertex shader
+} pc;
+
+//accessors for the draw state that work for both, ubo and push constants
+mat3 scissorTransform()
+{
+	if(!pushConstants) return mat3(ubo.scissorMat);
+	return mat3(vec3(pc.scissorMat.xy, 0.0), vec3(pc.scissorMat.zw, 0.0),
+		vec3(pc.scissorTranslateExtent.xy, 1.0));
+}
+
+vec2 scissorExtent()
+{
+	if(!pushConstants) return vec2(ubo.scissorMat[3]);
+	return pc.scissorTranslateExtent.zw;
+}
+
+vec2 scissorScale()
+{
+	if(!pushConstants) return vec2(ubo.scissorMat[3][2], ubo.scissorMat[3][3]);
+	return pc.scissorScaleViewSize.xy;
+}
+
+mat3 paintTransform()
+{
+	if(!pushConstants) return mat3(ubo.paintMat);
+	return mat3(vec3(pc.paintMat.xy, 0.0), vec3(pc.paintMat.zw, 0.0),
+		vec3(pc.paintTranslateExtent.xy, 1.0));
+}
+
+vec2 paintExtent()
+{
+	if(!pushConstants) return vec2(ubo.paintMat[3][0], ubo.paintMat[3][1]);
+	return pc.paintTranslateExtent.zw;
+}
+
+float radius() { return pushConstants ? pc.params.x : ubo.scissorMat[0][3]; }
+float feather() { return pushConstants ? pc.params.y : ubo.scissorMat[1][3]; }
+float strokeMult() { return pushConstants ? pc.params.z : ubo.paintMat[0][3]; }
+uint type() { return pushConstants ? pc.typeBits & 0xFFu : ubo.type; }
+uint texType() { return pushConstants ? pc.typeBits >> 8 : ubo.texType; }
+uint paint() { return (paintType != 0) ? paintType : type(); }
+uint format() { return (textureFormat != 0) ? textureFormat : texType() & 0xFFu; }
+
+vec4 innerColor()
+{
+	if(!pushConstants) return ubo.innerColor;
+	return vec4(unpackHalf2x16(pc.colors.x), unpackHalf2x16(pc.colors.y));
+}
+
+vec4 outerColor()
+{
+	if(!pushConstants) return ubo.outerColor;
+	return vec4(unpackHalf2x16(pc.colors.z), unpackHalf2x16(pc.colors.w));
+}
 
 float sdroundrect(vec2 pt, vec2 ext, float rad)
 {
@@ -63,53 +141,60 @@ float sdroundrect(vec2 pt, vec2 ext, float rad)
 
 float scissorMask(vec2 pos)
 {
-	vec2 sc = (abs((mat3(ubo.scissorMat) * vec3(pos, 1.0)).xy) - vec2(ubo.scissorMat[3]));
-	sc = vec2(0.5, 0.5) - sc * vec2(ubo.scissorMat[3][2], ubo.scissorMat[3][3]);
+	vec2 sc = (abs((scissorTransform() * vec3(pos, 1.0)).xy) - scissorExtent());
+	sc = vec2(0.5, 0.5) - sc * scissorScale();
 	return clamp(sc.x, 0.0, 1.0) * clamp(sc.y, 0.0, 1.0);
 }
 
 float strokeMask()
 {
-	float strokeMult = ubo.paintMat[0][3];
-	return min(1.0, (1.0 - abs(itexcoord.x * 2.0 - 1.0)) * strokeMult) * min(1.0, itexcoord.y);
+	return min(1.0, (1.0 - abs(itexcoord.x * 2.0 - 1.0)) * strokeMult()) * min(1.0, itexcoord.y);
 }
 
 void main()
 {
-	float scissorAlpha = scissorMask(ipos);
-	if(edgeAntiAlias && scissorAlpha < 0.5f) discard;
+	float scissorAlpha = 1.0;
+	if(scissored)
+	{
+		scissorAlpha = scissorMask(ipos);
+		if(edgeAntiAlias && scissorAlpha < 0.5f) discard;
+	}
 
-	float strokeAlpha = strokeMask();
-	if(strokeAlpha < strokeThr) discard;
+	float strokeAlpha = 1.0;
+	if(edgeAntiAlias && strokeAntiAlias)
+	{
+		strokeAlpha = strokeMask();
+		if(strokeAlpha < strokeThr) discard;
+	}
 
-	if(ubo.type == TYPE_COLOR)
+	if(paint() == TYPE_COLOR)
 	{
-		ocolor = ubo.innerColor;
-		if(edgeAntiAlias) ocolor *= strokeAlpha;
+		ocolor = innerColor() * strokeAlpha;
 	}
-	else if(ubo.type == TYPE_GRADIENT)
+	else if(paint() == TYPE_GRADIENT)
 	{
-		vec2 pt = (mat3(ubo.paintMat) * vec3(ipos, 1.0)).xy;
+		vec2 pt = (paintTransform() * vec3(ipos, 1.0)).xy;
 		// vec2 pt = ipos;
-		float ft = ubo.scissorMat[1][3];
+		float ft = feather();
 		// float fac = sdroundrect(pt, vec2(ubo.paintMat[3]), ubo.scissorMat[0][3]) / ft;
 		// ocolor = mix(ubo.innerColor, ubo.outerColor, clamp(0.5 + fac, 0.0, 1.0));
 		// // ocolor = vec4(1.0, 0.0, 1.0, 1.0);
 		//
-		vec2 extent = vec2(ubo.paintMat[3][0], ubo.paintMat[3][1]);
-		float radius = ubo.scissorMat[0][3];
-		float d = clamp((sdroundrect(pt, extent, radius) + ft*0.5) / ft, 0.0, 1.0);
-		ocolor = mix(ubo.innerColor,ubo.outerColor,d);
+		vec2 extent = paintExtent();
+		float d = clamp((sdroundrect(pt, extent, radius()) + ft*0.5) / ft, 0.0, 1.0);
+		ocolor = mix(innerColor(), outerColor(), d);
 		// ocolor = vec4(radius, extent.x, extent.y, 1.0);
-		if(edgeAntiAlias) ocolor *= strokeAlpha;
+		ocolor *= strokeAlpha;
 	}
-	else if(ubo.type == TYPE_TEXTURE)
+	else if(paint() == TYPE_TEXTURE)
 	{
-		ocolor = texture(tex, itexcoord);
-		if(ubo.texType == TEXTYPE_RGBA) ocolor = vec4(ocolor.xyz * ocolor.w, ocolor.w);
-		else if(ubo.texType == TEXTYPE_A) ocolor = vec4(ocolor.x);
-		ocolor = ocolor * ubo.innerColor;
+		//the upper bits of texType select the texture in the array
+		ocolor = texture(tex[texType() >> 8], itexcoord);
+		if(format() == TEXTYPE_RGBA) ocolor = vec4(ocolor.xyz * ocolor.w, ocolor.w);
+		else if(format() == TEXTYPE_A) ocolor = vec4(ocolor.x);
+		else if(format() == TEXTYPE_PREMULT && ocolor.w > 0.0) ocolor.xyz /= ocolor.w;
+		ocolor = ocolor * innerColor();
 	}
 
-	ocolor *= scissorAlpha;
+	if(scissored) ocolor *= scissorAlpha;
 }
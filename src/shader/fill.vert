@@ -3,24 +3,45 @@
 #extension GL_ARB_separate_shader_objects : enable
 #extension GL_ARB_shading_language_420pack : enable
 
+layout(constant_id = 1) const bool pushConstants = false;
+
+//with packed vertices the positions are normalized integers that have to be scaled
+layout(constant_id = 7) const float positionScale = 1.0;
+
 layout(location = 0) in vec2 ivertex;
 layout(location = 1) in vec2 itexcoord;
 
 layout(location = 0) out vec2 opos;
 layout(location = 1) out vec2 otexcoord;
 
+//see fill.frag, only viewSize and the transform are needed here
+//the transform is stored in the free paintMat entries
 layout(set = 0, binding = 0) uniform UBO
 {
 	vec2 viewSize;
+	layout(offset = 112) mat4 paintMat;
 } ubo;
 
+layout(push_constant) uniform PushConstants
+{
+	layout(offset = 32) vec4 scissorScaleViewSize;
+	layout(offset = 112) vec4 transform;
+} pc;
+
 void main()
 {
 	//just perform interpolation for texture coords and screen position
 	otexcoord = itexcoord;
-	opos = ivertex;
+	vec2 vertex = ivertex * positionScale;
+	opos = vertex;
+
+	//translation, scale of retained operations (paint and scissor move with them)
+	vec4 transform = pushConstants ? pc.transform :
+		vec4(ubo.paintMat[3][2], ubo.paintMat[3][3], ubo.paintMat[1][3], ubo.paintMat[2][3]);
+	vec2 pos = vertex * transform.zw + transform.xy;
 
 	//normalize the vertex coords from ([0, width], [0, height]) to ([-1, 1], [-1, 1]).
 	//unlike in opengl there is no y inversion needed.
-	gl_Position = vec4(2.0 * ivertex / ubo.viewSize - 1.0, 0.0, 1.0);
+	vec2 viewSize = pushConstants ? pc.scissorScaleViewSize.zw : ubo.viewSize;
+	gl_Position = vec4(2.0 * pos / viewSize - 1.0, 0.0, 1.0);
 }
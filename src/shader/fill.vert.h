@@ -11,33 +11,47 @@
 #endif
 
 uint32_t fill_vert_data[] = {
-	119734787, 65536, 524289, 44, 0, 131089, 1, 393227, 1, 1280527431, 1685353262, 
-	808793134, 0, 196622, 0, 1, 655375, 0, 4, 1852399981, 0, 9, 11, 13, 14, 22, 
+	119734787, 65536, 0, 76, 0, 131089, 1, 393227, 1, 1280527431, 1685353262, 
+	808793134, 0, 196622, 0, 1, 655375, 0, 2, 1852399981, 0, 12, 14, 15, 17, 19, 
 	196611, 2, 450, 589828, 1096764487, 1935622738, 1918988389, 1600484449, 
 	1684105331, 1868526181, 1667590754, 29556, 589828, 1096764487, 1935622738, 
-	1768186216, 1818191726, 1969712737, 1600481121, 1882206772, 7037793, 262149, 4, 
-	1852399981, 0, 327685, 9, 2019914863, 1919905635, 100, 327685, 11, 2019914857, 
-	1919905635, 100, 262149, 13, 1936683119, 0, 262149, 14, 1919252073, 7890292, 
-	393221, 20, 1348430951, 1700164197, 2019914866, 0, 393222, 20, 0, 1348430951, 
-	1953067887, 7237481, 458758, 20, 1, 1348430951, 1953393007, 1702521171, 0, 
-	458758, 20, 2, 1130327143, 1148217708, 1635021673, 6644590, 458758, 20, 3, 
-	1130327143, 1147956341, 1635021673, 6644590, 196613, 22, 0, 196613, 28, 
-	5194325, 393222, 28, 0, 2003134838, 1702521171, 0, 196613, 30, 7299701, 262215, 
-	9, 30, 1, 262215, 11, 30, 1, 262215, 13, 30, 0, 262215, 14, 30, 0, 327752, 20, 
-	0, 11, 0, 327752, 20, 1, 11, 1, 327752, 20, 2, 11, 3, 327752, 20, 3, 11, 4, 
-	196679, 20, 2, 327752, 28, 0, 35, 0, 196679, 28, 2, 262215, 30, 34, 0, 262215, 
-	30, 33, 0, 131091, 2, 196641, 3, 2, 196630, 6, 32, 262167, 7, 6, 2, 262176, 8, 
-	3, 7, 262203, 8, 9, 3, 262176, 10, 1, 7, 262203, 10, 11, 1, 262203, 8, 13, 3, 
-	262203, 10, 14, 1, 262167, 16, 6, 4, 262165, 17, 32, 0, 262187, 17, 18, 1, 
-	262172, 19, 6, 18, 393246, 20, 16, 6, 19, 19, 262176, 21, 3, 20, 262203, 21, 
-	22, 3, 262165, 23, 32, 1, 262187, 23, 24, 0, 262187, 6, 25, 1073741824, 196638, 
-	28, 7, 262176, 29, 2, 28, 262203, 29, 30, 2, 262176, 31, 2, 7, 262187, 6, 35, 
-	1065353216, 262187, 6, 38, 0, 262176, 42, 3, 16, 327734, 2, 4, 0, 3, 131320, 5, 
-	262205, 7, 12, 11, 196670, 9, 12, 262205, 7, 15, 14, 196670, 13, 15, 262205, 7, 
-	26, 14, 327822, 7, 27, 26, 25, 327745, 31, 32, 30, 24, 262205, 7, 33, 32, 
-	327816, 7, 34, 27, 33, 327760, 7, 36, 35, 35, 327811, 7, 37, 34, 36, 327761, 6, 
-	39, 37, 0, 327761, 6, 40, 37, 1, 458832, 16, 41, 39, 40, 38, 35, 327745, 42, 
-	43, 22, 24, 196670, 43, 41, 65789, 65592
+	1768186216, 1818191726, 1969712737, 1600481121, 1882206772, 7037793, 262149, 2, 
+	1852399981, 0, 393221, 10, 1752397168, 1936617283, 1953390964, 115, 393221, 11, 
+	1769172848, 1852795252, 1818321747, 101, 262149, 12, 1919252073, 7890292, 
+	327685, 14, 2019914857, 1919905635, 100, 262149, 15, 1936683119, 0, 327685, 17, 
+	2019914863, 1919905635, 100, 393221, 18, 1348430951, 1700164197, 2019914866, 0, 
+	393222, 18, 0, 1348430951, 1953067887, 7237481, 196613, 19, 0, 196613, 21, 
+	5194325, 393222, 21, 0, 2003134838, 1702521171, 0, 393222, 21, 1, 1852399984, 
+	1952533876, 0, 196613, 22, 7299701, 393221, 24, 1752397136, 1936617283, 
+	1953390964, 115, 589830, 24, 0, 1936286579, 1400008563, 1701601635, 2003134806, 
+	1702521171, 0, 393222, 24, 1, 1851880052, 1919903347, 109, 196613, 25, 25456, 
+	262215, 10, 1, 1, 262215, 11, 1, 7, 262215, 12, 30, 0, 262215, 14, 30, 1, 
+	262215, 15, 30, 0, 262215, 17, 30, 1, 327752, 18, 0, 11, 0, 196679, 18, 2, 
+	327752, 21, 0, 35, 0, 262216, 21, 1, 5, 327752, 21, 1, 35, 112, 327752, 21, 1, 
+	7, 16, 196679, 21, 2, 262215, 22, 34, 0, 262215, 22, 33, 0, 327752, 24, 0, 35, 
+	32, 327752, 24, 1, 35, 112, 196679, 24, 2, 196630, 3, 32, 262165, 4, 32, 0, 
+	262165, 5, 32, 1, 262167, 6, 3, 2, 262167, 7, 3, 4, 262168, 8, 7, 4, 131092, 9, 
+	196657, 9, 10, 262194, 3, 11, 1065353216, 262176, 13, 1, 6, 262203, 13, 12, 1, 
+	262203, 13, 14, 1, 262176, 16, 3, 6, 262203, 16, 15, 3, 262203, 16, 17, 3, 
+	196638, 18, 7, 262176, 20, 3, 18, 262203, 20, 19, 3, 262174, 21, 6, 8, 262176, 
+	23, 2, 21, 262203, 23, 22, 2, 262174, 24, 7, 7, 262176, 26, 9, 24, 262203, 26, 
+	25, 9, 131091, 27, 196641, 28, 27, 262176, 36, 9, 7, 262187, 5, 37, 1, 262176, 
+	40, 2, 8, 262187, 5, 56, 0, 262176, 60, 2, 6, 262187, 3, 64, 1073741824, 
+	262187, 3, 68, 1065353216, 327724, 6, 67, 68, 68, 262187, 3, 72, 0, 262176, 74, 
+	3, 7, 327734, 27, 2, 0, 28, 131320, 29, 262205, 6, 30, 14, 196670, 17, 30, 
+	262205, 6, 31, 12, 327822, 6, 32, 31, 11, 196670, 15, 32, 196855, 34, 0, 
+	262394, 10, 33, 35, 131320, 33, 327745, 36, 38, 25, 37, 262205, 7, 39, 38, 
+	131321, 34, 131320, 35, 327745, 40, 41, 22, 37, 262205, 8, 42, 41, 393297, 3, 
+	43, 42, 3, 2, 393297, 3, 44, 42, 3, 3, 393297, 3, 45, 42, 1, 3, 393297, 3, 46, 
+	42, 2, 3, 458832, 7, 47, 43, 44, 45, 46, 131321, 34, 131320, 34, 458997, 7, 48, 
+	39, 33, 47, 35, 458831, 6, 49, 48, 48, 2, 3, 327813, 6, 50, 32, 49, 458831, 6, 
+	51, 48, 48, 0, 1, 327809, 6, 52, 50, 51, 196855, 54, 0, 262394, 10, 53, 55, 
+	131320, 53, 327745, 36, 57, 25, 56, 262205, 7, 58, 57, 458831, 6, 59, 58, 58, 
+	2, 3, 131321, 54, 131320, 55, 327745, 60, 61, 22, 56, 262205, 6, 62, 61, 
+	131321, 54, 131320, 54, 458997, 6, 63, 59, 53, 62, 55, 327822, 6, 65, 52, 64, 
+	327816, 6, 66, 65, 63, 327811, 6, 69, 66, 67, 327761, 3, 70, 69, 0, 327761, 3, 
+	71, 69, 1, 458832, 7, 73, 70, 71, 72, 68, 327745, 74, 75, 19, 56, 196670, 75, 
+	73, 65789, 65592
 };
 
 #endif //header guard
\ No newline at end of file
@@ -12,6 +12,19 @@
 #include <vpp/buffer.hpp>
 #include <vpp/pipeline.hpp>
 #include <vpp/descriptor.hpp>
+#include <vpp/framebuffer.hpp>
+
+#include <unordered_map>
+#include <deque>
+#include <array>
+#include <future>
+#include <string>
+#include <functional>
+#include <memory>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 typedef struct NVGcontext NVGcontext;
 typedef struct NVGvertex NVGvertex;
@@ -23,42 +36,376 @@ typedef struct NVGscissor NVGscissor;
 namespace vvg {
 
 struct DrawData;
+struct RenderFrame;
+struct TextureUpload;
+struct RenderImpl;
+struct UniformData;
+struct RecordState;
+struct TextureGarbage;
+
+class Renderer;
+class SharedResources;
+
+/// Settings for a Renderer that can be passed on construction.
+struct RendererSettings {
+	/// The number of frames that may be processed by the device at the same time.
+	/// With 1 (the default) every flush blocks until the device has finished the frame.
+	/// With 2 or 3 the next frame can be built on the cpu while the device still renders
+	/// the previous ones, flush will only block when all frames are still in flight.
+	unsigned int framesInFlight = 1;
+
+	/// Whether the per-draw paint and scissor state should be passed as push constants
+	/// instead of being uploaded to the uniform buffer. The state is compacted to fit into
+	/// the guaranteed 128 bytes of push constants.
+	bool pushConstants = false;
+
+	/// If not 0, all textures are bound as one array of sampled images with the given size
+	/// and selected per draw. Changing the texture then no longer requires binding another
+	/// descriptor set. At most this many textures can exist at the same time.
+	/// The device must have the shaderSampledImageArrayDynamicIndexing feature enabled.
+	unsigned int textureArraySize = 0;
+
+	/// Whether fan and strip geometry should be converted to indexed triangle lists.
+	/// All paths of a draw are then rendered with one indexed draw call using a single
+	/// pipeline. Also avoids triangle fans, which are not supported by all devices.
+	bool indexedGeometry = false;
+
+	/// If not 0, vertices are packed into 8 instead of 16 bytes: positions as 16 bit
+	/// normalized integers in units of 1/packedVertices pixels and the texture coordinates
+	/// as 16 bit unorm values. Positions must then lie in [-32767, 32767] / packedVertices,
+	/// e.g. [-8191.75, 8191.75] for 4. Reduces the uploaded vertex data by half.
+	unsigned int packedVertices = 0;
+
+	/// Whether flush should skip frames that are identical to the last rendered one.
+	/// Such frames are neither uploaded, submitted nor presented, the last rendered
+	/// contents stay on the render target. Use Renderer::frameElided to check whether
+	/// the last frame was skipped.
+	bool elideIdenticalFrames = false;
+
+	/// Directory in which the pipeline cache is stored. The cache file is named after the
+	/// pipeline cache uuid and driver version of the device, so caches of different devices
+	/// or drivers never overwrite each other. If empty, no cache file is used.
+	std::string pipelineCacheDirectory = ".";
+
+	/// The number of samples per pixel. If not e1, the geometry is drawn into multisampled
+	/// color and stencil attachments that are resolved into the render target. The nanovg
+	/// context is then created without edge antialiasing, so no fringe geometry is generated.
+	/// When rendering into a framebuffer, its render pass must use the resolve target as
+	/// attachment 0, the multisampled stencil as attachment 1 and the multisampled color
+	/// as attachment 2 (which is cleared).
+	vk::SampleCountBits sampleCount = vk::SampleCountBits::e1;
+
+	/// The number of threads the draws of a frame are recorded on. With more than one,
+	/// large frames are split into contiguous chunks of draws that are recorded into
+	/// secondary command buffers in parallel and executed in order.
+	/// Only used when rendering into a framebuffer.
+	unsigned int recordThreads = 1;
+
+	/// Runs task(i) for all i in [0, count) and returns once all of them have finished.
+	/// Allows to record the chunks on an own thread pool. If empty, the chunks are
+	/// recorded using std::async.
+	std::function<void(unsigned int count, const std::function<void(unsigned int)>& task)>
+		executor;
+
+	/// Whether the device execution time of every frame should be measured using timestamp
+	/// queries, see Renderer::gpuTimings. The results are read back once the resources of
+	/// the frame are reused, so they never stall but lag behind by up to framesInFlight
+	/// frames. Ignored if the queue used for rendering does not support timestamps.
+	bool gpuTimings = false;
+
+	/// Resources shared with other renderers on the same device. If empty, the renderer
+	/// creates its own. The pushConstants, textureArraySize, indexedGeometry, packedVertices,
+	/// sampleCount and pipelineCacheDirectory settings of the shared resources are used
+	/// instead of the ones given here.
+	std::shared_ptr<SharedResources> sharedResources;
+};
+
+/// Statistics about the frame that is currently built or was last flushed.
+/// Reset every time a new frame is started.
+struct FrameStats {
+	/// The number of draws that were merged into the previous draw since they used
+	/// the same render state.
+	unsigned int mergedDraws {};
+
+	/// The number of fills that were drawn directly since they were a single convex path.
+	unsigned int convexFills {};
+
+	/// The number of fills that were drawn using the stencil buffer.
+	unsigned int stencilFills {};
+
+	/// The number of command buffers that were submitted without being recorded again
+	/// since the structure of the frame did not change.
+	unsigned int recordingsReused {};
+
+	/// The number of command buffers that had to be recorded.
+	unsigned int recordingsRecorded {};
+
+	/// The number of pipeline binds in the recorded command buffers. Every draw uses the
+	/// pipeline variant specialized for its paint, the pipeline is only bound again
+	/// when the variant changes.
+	unsigned int pipelineBinds {};
+
+	/// The number of descriptor set binds and draw commands in the recorded command buffers.
+	/// Like pipelineBinds only counted when the frame was recorded.
+	unsigned int descriptorBinds {};
+	unsigned int drawCommands {};
+
+	/// The number of draws of the flushed frame after merging. Operations count as one draw.
+	unsigned int draws {};
+
+	/// The number of vertices of the flushed frame, not including operations.
+	std::size_t vertices {};
+
+	/// The bytes written to the device for vertices (and indices), uniform data and
+	/// texture uploads. Includes the geometry of operations captured in this frame.
+	std::size_t vertexBytes {};
+	std::size_t uniformBytes {};
+	std::size_t textureBytes {};
+
+	/// The number of descriptor sets that were allocated and the number of buffers that had
+	/// to be (re)created because they were too small.
+	unsigned int descriptorSetsAllocated {};
+	unsigned int bufferReallocations {};
+
+	/// Cpu time in milliseconds spent tessellating paths and text in nanovg, writing the
+	/// frame data and uploading textures in flush, recording and submitting the frame.
+	/// On a swapchain the submit time also includes acquiring and presenting the image.
+	double tessellationTime {};
+	double uploadTime {};
+	double recordTime {};
+	double submitTime {};
+};
+
+/// Device execution times of a flushed frame in milliseconds.
+/// Only measured if the gpuTimings setting is set.
+struct GpuTimings {
+	/// The number of the flushed frame the timings belong to, starting with 1.
+	/// 0 if no timings were read back yet.
+	std::uint64_t frame {};
+
+	/// The time of the whole frame. When rendering into a framebuffer this includes
+	/// clearing and resolving the attachments, on a swapchain only the recorded draws.
+	double total {};
+
+	/// The time spent in the draws created by fills, strokes and triangles (i.e. text).
+	/// Consecutive draws of the same kind are measured as one group, at most 256 groups
+	/// are measured per frame. Not measured if the frame was recorded in parallel.
+	double fills {};
+	double strokes {};
+	double triangles {};
+};
 
-// TODO: make work async, e.g. let texture store a work pointer and only finish it when used.
 /// Represents a vulkan texture.
+/// Textures use optimal tiling and device local memory if their format supports it.
 /// Can be retrieved from the nanovg texture handle using the associated renderer.
 class Texture : public vpp::ResourceReference<Texture> {
 public:
 	Texture() = default;
+
+	/// If initLayout is false, the image is left in the undefined layout and must be
+	/// transitioned to layout() on the device before it is sampled. Otherwise the
+	/// constructor blocks until the layout was changed and the data was filled in.
+	/// The given usage flags are added to the ones needed for sampling and uploads.
 	Texture(const vpp::Device& dev, unsigned int xid, const vk::Extent2D& size,
-		vk::Format format, const std::uint8_t* data = nullptr);
+		vk::Format format, const std::uint8_t* data = nullptr, bool initLayout = true,
+		vk::ImageUsageFlags usage = {});
 	~Texture() = default;
 
 	Texture(Texture&& other) noexcept = default;
 	Texture& operator=(Texture&& other) noexcept = default;
 
-	///Updates the texture data at the given position and the given size.
-	///Note that the given data is NOT tightly packed but must hold data for the whole texture
-	///extent.
-	void update(const vk::Offset2D& offset, const vk::Extent2D& size, const std::uint8_t& data);
-
 	unsigned int id() const { return id_; }
 	unsigned int width() const { return width_; }
 	unsigned int height() const { return height_; }
 	vk::Format format() const { return format_; }
+	vk::ImageLayout layout() const { return layout_; } // layout when sampled
+	bool premultiplied() const { return premultiplied_; } // true for layers
 	const vpp::ViewableImage& viewableImage() const { return viewableImage_; }
 
 	const auto& resourceRef() const { return viewableImage_; }
 
 protected:
+	friend class Layer;
+
 	vpp::ViewableImage viewableImage_;
 	vk::Format format_;
+	vk::ImageLayout layout_;
 	unsigned int id_;
 	unsigned int width_;
 	unsigned int height_;
+	bool premultiplied_ {};
+};
+
+/// Entry in the texture registry of a Renderer.
+/// The nanovg texture handle stores the index of the slot and its generation, the generation
+/// is increased every time the texture in the slot is deleted to detect stale handles.
+struct TextureSlot {
+	Texture texture;
+	vpp::DescriptorSet descriptorSet; // not used if a texture array is used
+	unsigned int generation {};
+	std::uint64_t version {}; // increased every time the contents change
+	bool used {};
+};
+
+/// Value of a RenderOperation that can be changed after the operation was recorded.
+/// Changing it only rewrites the uniform data of the operation, the geometry stays untouched.
+template<typename T>
+class DynamicParameter {
+public:
+	DynamicParameter() = default;
+	DynamicParameter(const T& value) : value_(value) {}
+
+	void set(const T& value) { value_ = value; ++version_; }
+	const T& get() const { return value_; }
+
+	/// Increased every time the value is set.
+	unsigned int version() const { return version_; }
+
+protected:
+	T value_ {};
+	unsigned int version_ {};
+};
+
+/// Retained group of nanovg draw calls.
+/// All nanovg draw calls between Renderer::beginOperation and Renderer::endOperation are
+/// captured into the operation instead of the current frame. Their geometry is stored in
+/// buffers owned by the operation and is never tessellated or uploaded again, it can then be
+/// drawn any number of times using Renderer::draw.
+/// Drawing an operation whose parameters did not change costs no cpu time except
+/// recording its draw commands.
+/// The textures used by an operation must stay valid as long as it is drawn and the operation
+/// must not be destroyed while a frame in flight uses it (see Renderer::wait).
+class RenderOperation {
+public:
+	/// Translation in pixels that is applied after the operation was scaled.
+	/// Paint and scissor are transformed with the geometry.
+	DynamicParameter<std::array<float, 2>> position {{{0.f, 0.f}}};
+
+	/// Scale of the geometry, relative to the origin.
+	DynamicParameter<std::array<float, 2>> scale {{{1.f, 1.f}}};
+
+	/// Color all paint colors of the operation are multiplied with (rgba).
+	DynamicParameter<std::array<float, 4>> color {{{1.f, 1.f, 1.f, 1.f}}};
+
+public:
+	RenderOperation();
+	~RenderOperation();
+
+	RenderOperation(RenderOperation&&) noexcept;
+	RenderOperation& operator=(RenderOperation&&) noexcept;
+
+	/// Returns whether no draw calls were captured.
+	bool empty() const;
+
+protected:
+	friend class Renderer;
+
+	std::vector<DrawData> draws_;
+	std::uint64_t version_ {}; // changed every time the operation is captured
+	const Renderer* renderer_ {}; // the renderer that captured the operation
+	unsigned int convexFills_ {}; // fill statistics of the captured draws
+	unsigned int stencilFills_ {};
+
+	vpp::Buffer vertexBuffer_;
+	vpp::Buffer indexBuffer_; // only used with indexedGeometry, 32 bit indices
+	vpp::Buffer uniformBuffer_; // one slot per frame in flight and draw
+	vpp::DescriptorPool descriptorPool_;
+	vpp::DescriptorSet uniformSet_;
+	std::vector<std::uint64_t> slotHashes_; // parameters written into the slots
+};
+
+/// Pipeline that is only created when it is needed.
+struct LazyPipeline {
+	vpp::Pipeline pipeline;
+	std::future<vk::Pipeline> pending; // valid while created in the background
+};
+
+/// Resources that can be shared by multiple Renderers on the same device.
+/// Holds the sampler, the descriptor and pipeline layouts, the pipelines and pipeline
+/// cache and the texture registry. Textures created with one of the renderers can be used
+/// by all of them and nanovg contexts of renderers sharing the resources also share their
+/// fonts, so a font has to be loaded only once.
+/// All renderers sharing the resources must be used from the same thread and submit
+/// their work to the same queue. Must be created using std::make_shared.
+class SharedResources : public vpp::Resource,
+		public std::enable_shared_from_this<SharedResources> {
+public:
+	/// Only the pushConstants, textureArraySize, indexedGeometry, packedVertices, sampleCount
+	/// and pipelineCacheDirectory settings are used.
+	SharedResources(const vpp::Device& dev, const RendererSettings& settings = {});
+	~SharedResources();
+
+	/// Returns the texture with the given id.
+	/// Returns nullptr if there is no such texture or the texture was already deleted.
+	const Texture* texture(unsigned int id) const;
+	Texture* texture(unsigned int id);
+
+	const RendererSettings& settings() const { return settings_; }
+	const vpp::Sampler& sampler() const { return sampler_; }
+	const vpp::DescriptorSetLayout& uniformDescriptorLayout() const { return uniformLayout_; }
+	const vpp::DescriptorSetLayout& textureDescriptorLayout() const { return textureLayout_; }
+	const vpp::PipelineLayout& pipelineLayout() const { return pipelineLayout_; }
+
+protected:
+	friend class Renderer;
+	friend class BatchRenderer;
+	friend class Layer;
+	friend struct TextureGarbage;
+	friend NVGcontext* createContext(std::unique_ptr<Renderer> renderer);
+	friend void destroyContext(const NVGcontext& context);
+
+	void initPipelineCache();
+	void savePipelineCache();
+
+	void preparePipeline(vk::RenderPass renderPass, std::uint32_t key);
+	void resolvePipelines();
+	vk::Pipeline pipeline(vk::RenderPass renderPass, std::uint32_t key);
+	const vpp::RenderPass& swapchainRenderPass(vk::Format format);
+
+	const TextureSlot* textureSlot(unsigned int id) const;
+	void textureChanged(unsigned int id);
+	vpp::DescriptorSet createTextureSet(const Texture& texture);
+
+protected:
+	RendererSettings settings_;
+	bool edgeAA_ = false; // antialiasing using fringes, only used without multisampling
+
+	std::vector<Renderer*> renderers_; // receive the deleted textures
+	std::vector<NVGcontext*> contexts_; // contexts sharing their font atlas
+
+	std::deque<TextureSlot> textures_; // deque to keep textures stable in memory
+	std::vector<unsigned int> freeTextureSlots_; // indices of unused slots in textures_
+
+	std::vector<TextureUpload> uploads_; // pending texture uploads for the next flush
+	std::vector<std::uint8_t> uploadData_; // tightly packed data of the pending uploads
+	std::vector<unsigned int> pendingLayouts_; // created textures with undefined layout
+
+	std::vector<vpp::DescriptorSet> freeTextureSets_; // can be reused for new textures
+	std::vector<vpp::DescriptorPool> texturePools_;
+	unsigned int texturePoolUsed_ {}; // number of sets allocated from the last pool
+	unsigned int textureArrayVersion_ = 1; // increased every time a slot changes
+
+	vpp::Sampler sampler_;
+
+	vpp::DescriptorSetLayout uniformLayout_; // set 0: dynamic uniform buffer
+	vpp::DescriptorSetLayout textureLayout_; // set 1: texture sampler
+
+	vpp::PipelineLayout pipelineLayout_;
+	vpp::ShaderModule vertexShader_;
+	vpp::ShaderModule fragmentShader_;
+	vpp::PipelineCache pipelineCache_;
+	std::string pipelineCachePath_; // empty if the cache is not stored
+
+	// pipelines are created on first use for every render pass they are used with
+	using PipelineMap = std::unordered_map<std::uint32_t, LazyPipeline>;
+	std::vector<std::pair<vk::RenderPass, PipelineMap>> pipelines_;
+	std::deque<std::pair<vk::Format, vpp::RenderPass>> swapchainRenderPasses_;
+
+	Texture dummyTexture_;
+	vpp::DescriptorSet dummyTextureSet_;
+	bool dummyPending_ {}; // the layout of the dummy texture was not yet initialized
 };
 
-// TODO: how to handle swapchain resizes?
 /// The Renderer class implements the nanovg backend for vulkan using the vpp library.
 /// It can be used to gain more control over the rendering e.g. to just record the required
 /// commands to a given command buffer instead of executing them.
@@ -71,14 +418,18 @@ protected:
 class Renderer : public vpp::Resource {
 public:
 	Renderer() = default;
-	Renderer(const vpp::Swapchain& swapchain, const vpp::Queue* presentQueue = {});
+	Renderer(const vpp::Swapchain& swapchain, const vpp::Queue* presentQueue = {},
+		const RendererSettings& settings = {});
 
 	/// Constructs the Renderer for a vulkan framebuffer that can be rendered to with the given
-	/// render pass.
-	Renderer(const vpp::Framebuffer& fb, vk::RenderPass renderPass);
+	/// render pass. The render pass must have a stencil attachment that is cleared to 0.
+	Renderer(const vpp::Framebuffer& fb, vk::RenderPass renderPass,
+		const RendererSettings& settings = {});
 	virtual ~Renderer();
 
 	/// Returns the texture with the given id.
+	/// Returns nullptr if there is no such texture or the texture was already deleted.
+	/// Texture pointers stay valid until the texture is deleted.
 	const Texture* texture(unsigned int id) const;
 	Texture* texture(unsigned int id);
 
@@ -103,9 +454,39 @@ public:
 	void cancel();
 
 	/// Flushs the current frame, i.e. renders it on the render target.
-	/// This call will block until the device has finished its commands.
+	/// If framesInFlight is 1, this call will block until the device has finished its commands.
+	/// Otherwise it will only block until the resources of the oldest frame in flight
+	/// can be reused. Empty frames only clear framebuffers, they are not presented.
 	void flush();
 
+	/// Blocks until the device has finished all frames that are still in flight.
+	void wait();
+
+	/// Rebuilds the objects that depend on the swapchain (framebuffers, stencil attachments
+	/// and recorded command buffers) after it was resized or recreated. Textures, pipelines
+	/// and font atlases are kept. If a swapchain is given, it replaces the current one.
+	/// The frames in flight still use the old swapchain images, so wait() must be called
+	/// before the swapchain is resized. Only valid when rendering on a swapchain.
+	void resize(const vpp::Swapchain* swapchain = nullptr);
+
+	/// Called by nanovg with done = false before and done = true after it tessellates
+	/// paths or text. Used to measure FrameStats::tessellationTime.
+	void tessellation(bool done);
+
+	/// Starts capturing all following draw calls into the given operation.
+	/// Previous contents of the operation are discarded.
+	/// Must be ended with endOperation before the frame is flushed.
+	void beginOperation(RenderOperation& operation);
+
+	/// Ends capturing draw calls into the operation started with beginOperation and
+	/// uploads its geometry.
+	void endOperation();
+
+	/// Draws the given operation in the current frame.
+	/// The operation must not be destroyed or captured again until the frame was flushed.
+	/// Operations can only be drawn by the renderer that captured them.
+	void draw(RenderOperation& operation);
+
 	/// Records all given draw commands since the last start frame call to the given
 	/// command buffer. Note that the caller must assure that the commandBuffer is in a valid state
 	/// for this Renderer to record its commands (i.e. recording state, matching renderPass).
@@ -114,78 +495,350 @@ public:
 	void record(vk::CommandBuffer cmdBuffer);
 
 	/// Creates a texture for the given parameters and returns its id.
+	/// The given usage flags are added to the ones the image needs as texture.
 	unsigned int createTexture(vk::Format format, unsigned int width, unsigned int height,
-		const std::uint8_t* data = nullptr);
+		const std::uint8_t* data = nullptr, vk::ImageUsageFlags usage = {});
 
 	/// Deletes the texture with the given id.
+	/// The texture will only be destroyed once no frame in flight can reference it anymore.
 	/// If the given id could not be found returns false.
 	bool deleteTexture(unsigned int id);
 
-	const vpp::Sampler& sampler() const { return sampler_; }
-	const vpp::RenderPass& renderPass() const { return renderPass_; }
-	const vpp::Buffer& uniformBuffer() const { return uniformBuffer_; }
-	const vpp::Buffer& vertexBuffer() const { return vertexBuffer_; }
-	const vpp::DescriptorPool& descriptorPool() const { return descriptorPool_; }
-	const vpp::DescriptorSetLayout& descriptorLayout() const { return descriptorLayout_; }
-	const vpp::PipelineLayout& pipelineLayout() const { return pipelineLayout_; }
+	/// Updates the given region of the texture with the given id.
+	/// The data must hold the whole (tightly packed) texture but only the given region
+	/// is read. The region is copied into a staging buffer and uploaded to the device with
+	/// the next flushed frame. Returns false if the texture could not be found or the region
+	/// is out of bounds.
+	bool updateTexture(unsigned int id, const vk::Offset2D& offset, const vk::Extent2D& extent,
+		const std::uint8_t* data);
+
+	/// The buffers, uniform descriptor set and commandBuffer of the frame that is
+	/// currently built.
+	const vpp::Buffer& uniformBuffer() const;
+	const vpp::Buffer& vertexBuffer() const;
+	const vpp::DescriptorSet& uniformDescriptorSet() const;
+	const vpp::CommandBuffer& commandBuffer() const;
+
+	/// Returns the cached descriptor set for the texture with the given id.
+	/// Returns the descriptor set of a dummy texture if there is no such texture.
+	/// If a texture array is used, returns the texture array set of the current frame.
+	const vpp::DescriptorSet& textureDescriptorSet(unsigned int id) const;
+
+	const RendererSettings& settings() const { return settings_; }
+	const FrameStats& stats() const { return stats_; }
+
+	/// The device timings of the latest frame whose results were read back.
+	/// See the gpuTimings setting.
+	const GpuTimings& gpuTimings() const { return gpuTimings_; }
+
+	/// Returns whether the last flushed frame was skipped since it was identical to the
+	/// frame before. Only possible if the elideIdenticalFrames setting is set.
+	bool frameElided() const { return frameElided_; }
+
+	/// The render pass used for the swapchain. Not valid when rendering into a framebuffer.
+	const vpp::RenderPass& renderPass() const;
+
+	/// The resources of this renderer, can be passed to the settings of other renderers.
+	const std::shared_ptr<SharedResources>& sharedResources() const { return shared_; }
+	const vpp::Sampler& sampler() const { return shared_->sampler(); }
+	const vpp::DescriptorSetLayout& uniformDescriptorLayout() const
+		{ return shared_->uniformDescriptorLayout(); }
+	const vpp::DescriptorSetLayout& textureDescriptorLayout() const
+		{ return shared_->textureDescriptorLayout(); }
+	const vpp::PipelineLayout& pipelineLayout() const { return shared_->pipelineLayout(); }
 
 	const vpp::Swapchain* swapchain() const { return swapchain_; }
 	const vpp::SwapchainRenderer& renderer() const { return renderer_; }
 
 	const vpp::Framebuffer* framebuffer() const { return framebuffer_; }
-	const vpp::CommandBuffer& commandBuffer() const { return commandBuffer_; }
-	vk::RenderPass vkRenderPass() const
-		{ return swapchain_ ? renderPass_ : renderPassHandle_; }
+	vk::RenderPass vkRenderPass() const { return renderPassHandle_; }
 
 protected:
+	friend struct RenderImpl; // reuses the swapchain recordings
+
 	void init();
-	void initRenderPass(const vpp::Device& dev, vk::Format attachment);
+	void initSwapchainRenderer();
+	void detach();
+
+	/// Called after the render pass of a frame rendered into a framebuffer was recorded.
+	/// Allows derived classes to record additional commands for the frame with the given
+	/// index in the ring of frames in flight.
+	virtual void recordAfterRenderPass(vk::CommandBuffer, unsigned int) {}
+
+	/// Called after the frame with the given index was submitted and once the device
+	/// has finished it (before its resources are reused).
+	virtual void frameSubmitted(unsigned int) {}
+	virtual void frameFinished(unsigned int) {}
 
 	//for the c implementation
 	Renderer& operator=(Renderer&& other) = default;
 
+	void mergeDraw();
+	void addVertices(const NVGvertex* vertices, std::size_t count);
+	std::size_t vertexCount() const { return vertices_.size() / vertexStride_; }
+	void generateIndices(std::vector<DrawData>& draws, std::vector<std::uint32_t>& indices);
+	void updateOperation(RenderOperation& operation);
+	void recordRange(vk::CommandBuffer cmdBuffer, std::size_t begin, std::size_t end,
+		RecordState& state);
+	void recordTimed(vk::CommandBuffer cmdBuffer, std::vector<std::uint8_t>& groups);
+	void recordParallel(RenderFrame& frame, std::size_t chunks);
+	void recordDraw(vk::CommandBuffer cmdBuffer, const DrawData& data,
+		const UniformData& uniformData, vk::DescriptorSet uniformSet,
+		std::uint32_t uniformOffset, RecordState& state);
+	std::uint64_t structureHash(const RenderFrame& frame) const;
+	std::uint64_t contentHash() const;
+	bool reuseRecording(std::uint64_t& recordHash);
+
+	void preparePipelines();
 	DrawData& parsePaint(const NVGpaint& paint, const NVGscissor& scissor, float fringe,
 		float strokeWidth);
 
+	void updateTextureArray(RenderFrame& frame);
+	void upload(RenderFrame& frame, const vpp::Queue& queue);
+	void finishFrame(RenderFrame& frame);
+	void readTimestamps(RenderFrame& frame);
+
 protected:
+	std::shared_ptr<SharedResources> shared_; // destroyed last, frames may reference it
+
 	const vpp::Swapchain* swapchain_ = nullptr; // if rendering on swapchain
 	vpp::SwapchainRenderer renderer_; // used if rendering on swapchain
-	vpp::RenderPass renderPass_; // for swapchain
+	const vpp::RenderPass* renderPass_ {}; // for swapchain, owned by shared_
 
 	const vpp::Framebuffer* framebuffer_ = nullptr; // if rendering into framebuffer
-	vpp::CommandBuffer commandBuffer_; // commandBuffer to submit if rendering into fb
 	const vpp::Queue* renderQueue_; // queue used for rendering if rendering into fb
 	const vpp::Queue* presentQueue_; // queue for presenting
-	vk::RenderPass renderPassHandle_; // for framebuffer
+	vk::RenderPass renderPassHandle_; // the render pass the pipelines are used with
 
-	unsigned int texID_ = 0; // the currently highest texture id
-	std::vector<Texture> textures_;
+	// deleted since the last flush, shared with all renderers using the texture registry
+	std::vector<std::shared_ptr<TextureGarbage>> deletedTextures_;
 
-	vpp::Buffer uniformBuffer_;
-	vpp::Buffer vertexBuffer_;
+	std::vector<RenderFrame> frames_; // ring of per-frame resources
+	unsigned int frameIndex_ = 0; // the frame that is currently built
+	std::uint64_t resourceVersion_ {}; // last version assigned to a RenderFrame
+
+	std::uint64_t recordHash_ {}; // structure hash of the frame that is flushed
+	std::vector<std::uint64_t> imageRecordHashes_; // recorded hash per swapchain image
+	std::vector<std::vector<std::uint8_t>> imageTimestampGroups_; // per swapchain image
+	std::vector<unsigned int> imageFrames_; // frame that last submitted a swapchain image
+	std::uint64_t lastContentHash_ {}; // content hash of the last rendered frame
+	bool frameElided_ {};
 
 	std::vector<DrawData> drawDatas_;
-	std::vector<NVGvertex> vertices_;
+	std::vector<std::uint8_t> vertices_; // in the format given by the settings
+	std::size_t vertexStride_ {}; // size of a vertex in vertices_
+	std::vector<std::uint32_t> indices_; // only used with indexedGeometry
+
+	RenderOperation* operation_ {}; // the operation that is currently captured
+	std::size_t operationDrawStart_ {}; // first draw in drawDatas_ of the operation
+	std::size_t operationVertexStart_ {}; // first vertex in vertices_ of the operation
 
 	unsigned int width_ {};
 	unsigned int height_ {};
+	std::array<float, 4> clearColor_ {{0.f, 0.f, 0.f, 1.f}}; // the target is cleared with
+	bool blendAlpha_ {}; // accumulate coverage in the target alpha instead of replacing it
 
-	vpp::Sampler sampler_;
+	FrameStats stats_;
+	GpuTimings gpuTimings_;
+	std::chrono::steady_clock::time_point tessellationStart_;
+	std::uint64_t frameCount_ {}; // number of flushed frames
+	float timestampPeriod_ {}; // nanoseconds per timestamp tick
 
-	vpp::DescriptorPool descriptorPool_;
-	vpp::DescriptorSetLayout descriptorLayout_;
-	unsigned int descriptorPoolSize_ {}; // current maximal draw calls count
+	// settings
+	RendererSettings settings_;
+	bool edgeAA_ = false; // antialiasing using fringes, only used without multisampling
+};
 
-	vpp::PipelineLayout pipelineLayout_;
-	vpp::Pipeline fanPipeline_;
-	vpp::Pipeline stripPipeline_;
-	vpp::Pipeline listPipeline_;
-	unsigned int bound_ = 0;
+/// Pixels of a frame rendered by an OffscreenRenderer.
+struct OffscreenImage {
+	std::uint64_t frame {}; // the number of the flushed frame, starting with 1
+	vk::Extent2D size {};
+	vk::Format format {};
+	std::vector<std::uint8_t> data; // tightly packed rows, 4 bytes per pixel
+};
 
-	Texture dummyTexture_;
+/// Render pass and framebuffer of an OffscreenRenderer.
+/// Base class so that they are created before the Renderer that uses them.
+class OffscreenTarget {
+protected:
+	OffscreenTarget(const vpp::Device& dev, const vk::Extent2D& size, vk::Format format,
+		vk::SampleCountBits samples);
 
-	// settings
-	bool edgeAA_ = false;
+	vpp::RenderPass targetRenderPass_;
+	vpp::Framebuffer targetFramebuffer_;
+};
+
+/// Renderer that renders into its own device local image instead of a swapchain, e.g. for
+/// headless rendering. Every flushed frame is copied into a host visible readback buffer of
+/// the frame. The pixels are delivered once the device has finished the frame and its
+/// resources are reused by a later flush, so with framesInFlight >= 2 the readback of a frame
+/// overlaps with rendering the following ones. wait() delivers all pending frames.
+/// Frames are not delivered in the background: when no further frames are flushed,
+/// wait() has to be called before blocking on the future of nextFrame.
+class OffscreenRenderer : protected OffscreenTarget, public Renderer {
+public:
+	using Callback = std::function<void(const OffscreenImage&)>;
+
+	/// The format must have 4 bytes per pixel and support being used as color attachment.
+	OffscreenRenderer(const vpp::Device& dev, const vk::Extent2D& size,
+		vk::Format format = vk::Format::r8g8b8a8Unorm, const RendererSettings& settings = {});
+	~OffscreenRenderer();
+
+	/// Sets the callback that is called with the pixels of every delivered frame.
+	/// Called from flush or wait on the thread using the renderer.
+	void onFrame(Callback callback) { callback_ = std::move(callback); }
+
+	/// Returns a future for the pixels of the next submitted frame.
+	/// Only becomes ready once the frame is delivered by a later flush or by wait(),
+	/// see the class description.
+	std::future<OffscreenImage> nextFrame();
+
+	const vpp::ViewableImage& image() const;
+	const vk::Extent2D& size() const { return size_; }
+	vk::Format format() const { return format_; }
+
+protected:
+	void recordAfterRenderPass(vk::CommandBuffer cmdBuffer, unsigned int frame) override;
+	void frameSubmitted(unsigned int frame) override;
+	void frameFinished(unsigned int frame) override;
+
+protected:
+	struct Readback {
+		vpp::Buffer buffer;
+		std::uint64_t frame {}; // number of the frame copied into the buffer, 0 if none
+		std::vector<std::promise<OffscreenImage>> promises;
+	};
+
+	vk::Extent2D size_;
+	vk::Format format_;
+	std::vector<Readback> readbacks_; // one per frame in flight
+	std::vector<std::promise<OffscreenImage>> requests_; // for the next submitted frame
+	Callback callback_;
+};
+
+/// Settings for a BatchRenderer.
+struct BatchSettings {
+	/// The number of worker threads building and rendering the scenes.
+	/// If 0, the number of hardware threads is used.
+	unsigned int threads = 0;
+
+	/// The number of jobs every worker can have in flight on the device.
+	/// Overrides renderer.framesInFlight.
+	unsigned int jobsInFlight = 3;
+
+	/// The maximum number of renderers (one per target size) every worker keeps.
+	/// When exceeded, the least recently used one is destroyed.
+	unsigned int renderersPerThread = 4;
+
+	/// The format of the rendered images, must have 4 bytes per pixel.
+	vk::Format format = vk::Format::r8g8b8a8Unorm;
+
+	/// Settings for the renderers. Every worker creates its own SharedResources from them,
+	/// so the sharedResources member is ignored. Every frame of a job is rendered and read
+	/// back, so elideIdenticalFrames is ignored as well. All workers load the pipeline
+	/// cache, only the first one stores it (including the pipelines of the others).
+	RendererSettings renderer;
+
+	/// Called on the worker thread for the first nanovg context of the worker, e.g. to load
+	/// fonts. The contexts of a worker share fonts and images, so it is only called again
+	/// when all of them were destroyed.
+	std::function<void(NVGcontext&)> contextInit;
+};
+
+/// Renders scenes into memory at high throughput, e.g. to generate many thumbnails without
+/// initializing vulkan for each of them. The scenes are built on a pool of worker threads
+/// that each keep their own resources and a pool of OffscreenRenderers with nanovg contexts,
+/// so only the first scene of a given size on a worker creates vulkan objects.
+/// Since all workers submit to the same queue, only the flushes are serialized.
+class BatchRenderer {
+public:
+	/// Issues the nanovg calls of a scene. The frame is begun and ended by the batch.
+	/// Called on one of the worker threads.
+	using Scene = std::function<void(NVGcontext&)>;
+
+	BatchRenderer(const vpp::Device& dev, const BatchSettings& settings = {});
+
+	/// Finishes all added jobs before the workers are joined.
+	~BatchRenderer();
+
+	/// Adds a job rendering the given scene into an image with the given size.
+	/// The returned future becomes ready once the pixels were read back or holds the
+	/// exception thrown by the scene.
+	std::future<OffscreenImage> add(const vk::Extent2D& size, Scene scene);
+
+	/// Blocks until all added jobs are finished.
+	void wait();
+
+	const vpp::Device& device() const { return device_; }
+	const BatchSettings& settings() const { return settings_; }
+
+protected:
+	struct Job {
+		vk::Extent2D size;
+		Scene scene;
+		std::promise<OffscreenImage> promise;
+	};
+
+	void work(std::shared_ptr<SharedResources> shared);
+	void finished();
+
+protected:
+	const vpp::Device& device_;
+	BatchSettings settings_;
+
+	std::mutex mutex_;
+	std::condition_variable jobsCondition_; // signaled on new jobs and exit
+	std::condition_variable idleCondition_; // signaled when a job is finished
+	std::deque<Job> jobs_;
+	unsigned int pending_ {}; // added but not finished jobs
+	bool exit_ {};
+
+	std::mutex submitMutex_; // held while a worker submits, waits for or destroys frames
+	std::vector<std::shared_ptr<SharedResources>> shared_; // of the workers, in order
+	std::vector<std::thread> threads_;
+};
+
+/// Offscreen color and stencil target that nanovg frames can be rendered into, e.g. to
+/// cache static content like legends, backgrounds or complex icons.
+/// The color attachment is a texture of the resources of the given renderer, so it can be
+/// used as nanovg image handle (e.g. with nvgImagePattern) in all contexts sharing them.
+/// The layer has its own renderer and nanovg context, which share the textures and fonts.
+/// The contents are only rendered when the layer was marked dirty, new layers are dirty.
+/// Can only be used from the thread using the renderers sharing the resources.
+class Layer {
+public:
+	/// The settings are used for the renderer of the layer. The resources of the
+	/// given renderer are used, so the sharedResources member is ignored.
+	Layer(Renderer& renderer, const vk::Extent2D& size, const RendererSettings& settings = {});
+	~Layer();
+
+	Layer(const Layer&) = delete;
+	Layer& operator=(const Layer&) = delete;
+
+	/// Begins a frame rendering into the layer and returns the context to draw with.
+	/// The contents are cleared to transparent black. Must be ended with end().
+	NVGcontext& begin();
+
+	/// Ends and renders the frame begun with begin() and clears the dirty flag.
+	/// Frames of other renderers flushed afterwards see the new contents.
+	void end();
+
+	/// Marks the contents as outdated, the application should render them again.
+	void markDirty() { dirty_ = true; }
+	bool dirty() const { return dirty_; }
+
+	/// The nanovg image handle of the contents.
+	int image() const { return static_cast<int>(image_); }
+	NVGcontext& context() const { return *context_; }
+	const vk::Extent2D& size() const { return size_; }
+
+protected:
+	vk::Extent2D size_;
+	unsigned int image_ {};
+	vpp::RenderPass renderPass_;
+	vpp::Framebuffer framebuffer_;
+	NVGcontext* context_ {};
+	bool dirty_ = true;
 };
 
 /// Creates the nanovg context for the previoiusly created renderer object.
@@ -194,10 +847,11 @@ protected:
 NVGcontext* createContext(std::unique_ptr<Renderer> renderer);
 
 /// Creates the nanovg context for a given Swapchain.
-NVGcontext* createContext(const vpp::Swapchain& swapchain);
+NVGcontext* createContext(const vpp::Swapchain& swapchain, const RendererSettings& settings = {});
 
 /// Creates the nanovg context for a given Framebuffer and RenderPass.
-NVGcontext* createContext(const vpp::Framebuffer& fb, vk::RenderPass rp);
+NVGcontext* createContext(const vpp::Framebuffer& fb, vk::RenderPass rp,
+	const RendererSettings& settings = {});
 
 /// Destroys a nanovg context that was created by this library.
 /// Note that passing a nanovg context that was not created by this library results in undefined